@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace Pargon
+{
+	void RunCommandListBenchmark();
+	auto RunDrawSortingBenchmark() -> bool;
+	auto RunResourceLockBenchmark() -> bool;
+
+	template<typename Function>
+	auto MeasureMilliseconds(int iterations, Function&& function) -> double
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (auto i = 0; i < iterations; i++)
+			function();
+
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+	}
+}
\ No newline at end of file
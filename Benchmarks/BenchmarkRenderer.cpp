@@ -0,0 +1,167 @@
+#include "BenchmarkRenderer.h"
+
+#include <cstring>
+
+using namespace Pargon;
+
+auto Pargon::SetupBenchmarkDevice(GraphicsDevice& device) -> BenchmarkRenderer*
+{
+	static Application application;
+
+	auto renderer = std::make_unique<BenchmarkRenderer>();
+	auto result = renderer.get();
+
+	device.Setup(application, std::move(renderer));
+	return result;
+}
+
+auto BenchmarkGeometryHandle::Update(Geometry* geometry) -> bool
+{
+	auto data = geometry->Data();
+
+	if (data.Size() >= static_cast<int>(sizeof(std::uint32_t)))
+	{
+		std::uint32_t value;
+		std::memcpy(std::addressof(value), data.begin(), sizeof(std::uint32_t));
+		FirstValue.store(value, std::memory_order_relaxed);
+	}
+
+	Uploads.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+auto BenchmarkMaterialHandle::Update(Material* material) -> bool
+{
+	return true;
+}
+
+auto BenchmarkTextureHandle::Update(Texture* texture) -> bool
+{
+	return true;
+}
+
+auto BenchmarkRenderer::HorizontalResolution() -> unsigned int
+{
+	return 1280;
+}
+
+auto BenchmarkRenderer::VerticalResolution() -> unsigned int
+{
+	return 720;
+}
+
+auto BenchmarkRenderer::CompileShader(StringView content, Material& material) -> ShaderCompilationResult
+{
+	ShaderCompilationResult result;
+	result.Success = true;
+	return result;
+}
+
+void BenchmarkRenderer::Setup(Application& application, RendererInformation& information)
+{
+	information.Type = "Benchmark";
+	information.Available = true;
+}
+
+auto BenchmarkRenderer::CreateGeometryHandle() -> std::unique_ptr<GeometryHandle>
+{
+	return std::make_unique<BenchmarkGeometryHandle>();
+}
+
+auto BenchmarkRenderer::CreateMaterialHandle() -> std::unique_ptr<MaterialHandle>
+{
+	return std::make_unique<BenchmarkMaterialHandle>();
+}
+
+auto BenchmarkRenderer::CreateTextureHandle() -> std::unique_ptr<TextureHandle>
+{
+	return std::make_unique<BenchmarkTextureHandle>();
+}
+
+void BenchmarkRenderer::BeginFrame()
+{
+	ExecutedPackets.Clear();
+}
+
+void BenchmarkRenderer::Execute(SequenceView<RenderPacket> packets)
+{
+	if (RecordPackets)
+	{
+		for (auto& packet : packets)
+			ExecutedPackets.Add(packet.Type);
+	}
+
+	Renderer::Execute(packets);
+}
+
+void BenchmarkRenderer::SetRenderTarget(Texture* texture, int slot)
+{
+}
+
+void BenchmarkRenderer::ClearColorTarget(float r, float g, float b, float a)
+{
+}
+
+void BenchmarkRenderer::SetDepthStencilTarget(Texture* texture)
+{
+}
+
+void BenchmarkRenderer::ClearDepthAndStencilTarget(float depth, int stencil)
+{
+}
+
+void BenchmarkRenderer::SetClippingRectangle(float x, float y, float width, float height)
+{
+}
+
+void BenchmarkRenderer::SetMaterial(Material* material)
+{
+}
+
+void BenchmarkRenderer::SetTexture(Texture* texture, int slot)
+{
+}
+
+void BenchmarkRenderer::SetVertexBuffer(Geometry* geometry, std::size_t vertexSize)
+{
+}
+
+void BenchmarkRenderer::SetVertexStream(Geometry* geometry, std::size_t vertexSize, int stream)
+{
+}
+
+void BenchmarkRenderer::SetInstanceBuffer(Geometry* geometry, std::size_t vertexSize)
+{
+}
+
+void BenchmarkRenderer::SetIndexBuffer(Geometry* geometry, std::size_t indexSize)
+{
+}
+
+void BenchmarkRenderer::SetConstantBuffer(Geometry* geometry, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot)
+{
+}
+
+void BenchmarkRenderer::DrawVertices(int firstVertex, int vertexCount)
+{
+}
+
+void BenchmarkRenderer::DrawIndices(int firstIndex, int indexCount)
+{
+}
+
+void BenchmarkRenderer::DrawInstances(int firstVertex, int vertexCount, int firstInstance, int instanceCount)
+{
+}
+
+void BenchmarkRenderer::DrawIndexedInstances(int firstIndex, int indexCount, int firstInstance, int instanceCount)
+{
+}
+
+void BenchmarkRenderer::MultiDraw(SequenceView<DrawRange> ranges, bool indexed)
+{
+}
+
+void BenchmarkRenderer::EndFrame(int synchronization)
+{
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Pargon/Graphics/GraphicsDevice.h"
+#include "Pargon/Graphics/Renderer.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace Pargon
+{
+	class BenchmarkGeometryHandle : public GeometryHandle
+	{
+	public:
+		std::atomic<std::uint32_t> FirstValue{ 0 };
+		std::atomic<int> Uploads{ 0 };
+
+	protected:
+		auto Update(Geometry* geometry) -> bool override;
+	};
+
+	class BenchmarkMaterialHandle : public MaterialHandle
+	{
+	protected:
+		auto Update(Material* material) -> bool override;
+	};
+
+	class BenchmarkTextureHandle : public TextureHandle
+	{
+	protected:
+		auto Update(Texture* texture) -> bool override;
+	};
+
+	class BenchmarkRenderer : public Renderer
+	{
+	public:
+		List<RenderPacketType> ExecutedPackets;
+		bool RecordPackets = false;
+
+		auto HorizontalResolution() -> unsigned int override;
+		auto VerticalResolution() -> unsigned int override;
+
+		auto CompileShader(StringView content, Material& material) -> ShaderCompilationResult override;
+
+	protected:
+		void Setup(Application& application, RendererInformation& information) override;
+
+		auto CreateGeometryHandle() -> std::unique_ptr<GeometryHandle> override;
+		auto CreateMaterialHandle() -> std::unique_ptr<MaterialHandle> override;
+		auto CreateTextureHandle() -> std::unique_ptr<TextureHandle> override;
+
+		void BeginFrame() override;
+		void Execute(SequenceView<RenderPacket> packets) override;
+		void SetRenderTarget(Texture* texture, int slot) override;
+		void ClearColorTarget(float r, float g, float b, float a) override;
+		void SetDepthStencilTarget(Texture* texture) override;
+		void ClearDepthAndStencilTarget(float depth, int stencil) override;
+		void SetClippingRectangle(float x, float y, float width, float height) override;
+		void SetMaterial(Material* material) override;
+		void SetTexture(Texture* texture, int slot) override;
+		void SetVertexBuffer(Geometry* geometry, std::size_t vertexSize) override;
+		void SetVertexStream(Geometry* geometry, std::size_t vertexSize, int stream) override;
+		void SetInstanceBuffer(Geometry* geometry, std::size_t vertexSize) override;
+		void SetIndexBuffer(Geometry* geometry, std::size_t indexSize) override;
+		void SetConstantBuffer(Geometry* geometry, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot) override;
+		void DrawVertices(int firstVertex, int vertexCount) override;
+		void DrawIndices(int firstIndex, int indexCount) override;
+		void DrawInstances(int firstVertex, int vertexCount, int firstInstance, int instanceCount) override;
+		void DrawIndexedInstances(int firstIndex, int indexCount, int firstInstance, int instanceCount) override;
+		void MultiDraw(SequenceView<DrawRange> ranges, bool indexed) override;
+		void EndFrame(int synchronization) override;
+	};
+
+	auto SetupBenchmarkDevice(GraphicsDevice& device) -> BenchmarkRenderer*;
+}
\ No newline at end of file
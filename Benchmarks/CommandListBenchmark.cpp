@@ -0,0 +1,190 @@
+#include "Benchmark.h"
+
+#include "Pargon/Graphics/CommandList.h"
+
+#include <cassert>
+#include <cstdint>
+
+namespace Pargon
+{
+	class CommandListBenchmark
+	{
+	public:
+		static void Run();
+
+	private:
+		using RenderCommand = CommandList::RenderCommand;
+		using RenderCommandType = CommandList::RenderCommandType;
+
+		static constexpr int _frameCommands = 100000;
+		static constexpr int _iterations = 50;
+
+		class LegacyCommandList
+		{
+		public:
+			List<RenderCommand> Commands;
+
+			void SetMaterial(MaterialId material);
+			void SetTexture(TextureId texture, int slot);
+			void SetVertexBuffer(GeometryId geometry, std::size_t vertexSize);
+			void SetConstantBuffer(GeometryId geometry, bool vertexAccess, bool fragmentAccess, int start, std::size_t size, int slot);
+			void Draw(int start, int count);
+		};
+
+		template<typename ListType> static void RecordFrame(ListType& commands);
+		static auto ConsumeCommand(const RenderCommand& command) -> std::uint64_t;
+		static auto IterateEncoded(const CommandList& commands) -> std::uint64_t;
+		static auto IterateLegacy(const LegacyCommandList& commands) -> std::uint64_t;
+	};
+}
+
+using namespace Pargon;
+
+void Pargon::RunCommandListBenchmark()
+{
+	CommandListBenchmark::Run();
+}
+
+void CommandListBenchmark::Run()
+{
+	CommandList encoded;
+	LegacyCommandList legacy;
+
+	auto encodedRecord = MeasureMilliseconds(_iterations, [&]()
+	{
+		encoded.Clear();
+		RecordFrame(encoded);
+	});
+
+	auto legacyRecord = MeasureMilliseconds(_iterations, [&]()
+	{
+		legacy.Commands.Clear();
+		RecordFrame(legacy);
+	});
+
+	assert(encoded.Count() == legacy.Commands.Count());
+
+	auto encodedSum = std::uint64_t(0);
+	auto legacySum = std::uint64_t(0);
+
+	auto encodedIterate = MeasureMilliseconds(_iterations, [&]() { encodedSum += IterateEncoded(encoded); });
+	auto legacyIterate = MeasureMilliseconds(_iterations, [&]() { legacySum += IterateLegacy(legacy); });
+
+	assert(encodedSum == legacySum);
+
+	auto encodedBytes = static_cast<std::size_t>(encoded._size);
+	auto legacyBytes = static_cast<std::size_t>(legacy.Commands.Count()) * sizeof(RenderCommand);
+
+	std::printf("CommandList - %d commands, average of %d frames\n", encoded.Count(), _iterations);
+	std::printf(" - encoded stream:      record %8.3f ms, iterate %8.3f ms, %9zu bytes\n", encodedRecord, encodedIterate, encodedBytes);
+	std::printf(" - List<RenderCommand>: record %8.3f ms, iterate %8.3f ms, %9zu bytes\n", legacyRecord, legacyIterate, legacyBytes);
+}
+
+template<typename ListType>
+void CommandListBenchmark::RecordFrame(ListType& commands)
+{
+	auto count = 0;
+
+	for (auto i = 0; count < _frameCommands; i++)
+	{
+		if (i % 64 == 0)
+		{
+			commands.SetMaterial(MaterialId{});
+			count++;
+		}
+
+		commands.SetTexture(TextureId{}, i % 4);
+		commands.SetVertexBuffer(GeometryId{}, 32);
+		commands.SetConstantBuffer(GeometryId{}, true, false, i % 1024, 64, 1);
+		commands.Draw(i % 16, 36);
+		count += 4;
+	}
+}
+
+auto CommandListBenchmark::ConsumeCommand(const RenderCommand& command) -> std::uint64_t
+{
+	auto& data = command.Data;
+
+	switch (command.Type)
+	{
+	case RenderCommandType::SetMaterial: return static_cast<std::uint64_t>(data.SetMaterial.Material.Assignment() + 1);
+	case RenderCommandType::SetTexture: return static_cast<std::uint64_t>(data.SetTexture.Slot);
+	case RenderCommandType::SetVertexBuffer: return data.SetVertexBuffer.VertexSize;
+	case RenderCommandType::SetConstantBuffer: return static_cast<std::uint64_t>(data.SetConstantBuffer.Start) + data.SetConstantBuffer.Size;
+	case RenderCommandType::Draw: return static_cast<std::uint64_t>(data.Draw.Start + data.Draw.Count);
+	default: return 0;
+	}
+}
+
+auto CommandListBenchmark::IterateEncoded(const CommandList& commands) -> std::uint64_t
+{
+	auto sum = std::uint64_t(0);
+
+	for (auto encoded = commands.Begin(); encoded != commands.End(); encoded = CommandList::Next(encoded))
+		sum += ConsumeCommand(CommandList::Read(encoded));
+
+	return sum;
+}
+
+auto CommandListBenchmark::IterateLegacy(const LegacyCommandList& commands) -> std::uint64_t
+{
+	auto sum = std::uint64_t(0);
+
+	for (auto& command : commands.Commands)
+		sum += ConsumeCommand(command);
+
+	return sum;
+}
+
+void CommandListBenchmark::LegacyCommandList::SetMaterial(MaterialId material)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetMaterial;
+	command.Data.SetMaterial.Material = material;
+
+	Commands.Add(command);
+}
+
+void CommandListBenchmark::LegacyCommandList::SetTexture(TextureId texture, int slot)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetTexture;
+	command.Data.SetTexture.Texture = texture;
+	command.Data.SetTexture.Slot = slot;
+
+	Commands.Add(command);
+}
+
+void CommandListBenchmark::LegacyCommandList::SetVertexBuffer(GeometryId geometry, std::size_t vertexSize)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetVertexBuffer;
+	command.Data.SetVertexBuffer.Geometry = geometry;
+	command.Data.SetVertexBuffer.VertexSize = vertexSize;
+
+	Commands.Add(command);
+}
+
+void CommandListBenchmark::LegacyCommandList::SetConstantBuffer(GeometryId geometry, bool vertexAccess, bool fragmentAccess, int start, std::size_t size, int slot)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetConstantBuffer;
+	command.Data.SetConstantBuffer.Geometry = geometry;
+	command.Data.SetConstantBuffer.Start = start;
+	command.Data.SetConstantBuffer.Size = size;
+	command.Data.SetConstantBuffer.Slot = slot;
+	command.Data.SetConstantBuffer.VertexAccess = vertexAccess;
+	command.Data.SetConstantBuffer.FragmentAccess = fragmentAccess;
+
+	Commands.Add(command);
+}
+
+void CommandListBenchmark::LegacyCommandList::Draw(int start, int count)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::Draw;
+	command.Data.Draw.Start = start;
+	command.Data.Draw.Count = count;
+
+	Commands.Add(command);
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "Benchmark.h"
+#include "BenchmarkRenderer.h"
+
+#include <iterator>
+
+using namespace Pargon;
+
+namespace
+{
+	constexpr int FrameCommands = 100000;
+	constexpr int LayerCount = 4;
+	constexpr int MaterialCount = 16;
+	constexpr int Iterations = 20;
+
+	void RecordFrame(GraphicsDevice& device, const List<Material*>& materials, GeometryId vertices, const List<DrawRange>& ranges)
+	{
+		auto count = 0;
+
+		for (auto i = 0; count < FrameCommands; i++)
+		{
+			device.SetLayer(i % LayerCount);
+			device.SetMaterial(materials.Item(i % MaterialCount)->Id());
+			device.SetVertexBuffer(vertices, 12);
+			count += 3;
+
+			if (i % 32 == 0)
+				device.MultiDraw(ranges);
+			else
+				device.Draw(0, 3);
+
+			count++;
+		}
+	}
+
+	auto CheckSortedMultiDraw(GraphicsDevice& device, BenchmarkRenderer& renderer, MaterialId material, GeometryId vertices, const List<DrawRange>& ranges) -> bool
+	{
+		device.SetCommandOptimization(false);
+		device.SetDrawSorting(true);
+
+		device.SetMaterial(material);
+		device.SetVertexBuffer(vertices, 12);
+		device.Draw(0, 3);
+		device.MultiDraw(ranges);
+		device.Draw(3, 3);
+
+		renderer.RecordPackets = true;
+		device.Render(GraphicsDevice::NoSynchronization);
+		renderer.RecordPackets = false;
+
+		RenderPacketType expected[] =
+		{
+			RenderPacketType::SetMaterial,
+			RenderPacketType::SetVertexBuffer,
+			RenderPacketType::DrawVertices,
+			RenderPacketType::MultiDraw,
+			RenderPacketType::DrawVertices
+		};
+
+		auto passed = renderer.ExecutedPackets.Count() == static_cast<int>(std::size(expected));
+
+		for (auto i = 0; passed && i < renderer.ExecutedPackets.Count(); i++)
+			passed = renderer.ExecutedPackets.Item(i) == expected[i];
+
+		return passed;
+	}
+}
+
+auto Pargon::RunDrawSortingBenchmark() -> bool
+{
+	GraphicsDevice device;
+	auto renderer = SetupBenchmarkDevice(device);
+
+	List<Material*> materials;
+
+	for (auto i = 0; i < MaterialCount; i++)
+	{
+		auto material = device.CreateMaterial(GraphicsStorage::CopiedToGpu);
+		material->Unlock();
+		materials.Add(material);
+	}
+
+	auto vertices = device.CreateGeometry(GraphicsStorage::CopiedToGpu);
+	vertices->Reset(GeometryTopology::TriangleList, 12 * 12);
+	vertices->Reserve(12, 12);
+	vertices->Unlock();
+
+	List<DrawRange> ranges;
+	ranges.Add({ 0, 3, 0, 0, 1 });
+	ranges.Add({ 3, 3, 0, 0, 1 });
+
+	device.SetCommandOptimization(true);
+
+	device.SetDrawSorting(false);
+	auto unsorted = MeasureMilliseconds(Iterations, [&]()
+	{
+		RecordFrame(device, materials, vertices->Id(), ranges);
+		device.Render(GraphicsDevice::NoSynchronization);
+	});
+
+	device.SetDrawSorting(true);
+	auto sorted = MeasureMilliseconds(Iterations, [&]()
+	{
+		RecordFrame(device, materials, vertices->Id(), ranges);
+		device.Render(GraphicsDevice::NoSynchronization);
+	});
+
+	auto passed = CheckSortedMultiDraw(device, *renderer, materials.First()->Id(), vertices->Id(), ranges);
+
+	std::printf("Draw Sorting - %d commands in %d layers, average of %d frames\n", FrameCommands, LayerCount, Iterations);
+	std::printf(" - unsorted: %8.3f ms\n", unsorted);
+	std::printf(" - sorted:   %8.3f ms\n", sorted);
+	std::printf(" - sorted frame with MultiDraw: %s\n", passed ? "passed" : "FAILED");
+
+	return passed;
+}
\ No newline at end of file
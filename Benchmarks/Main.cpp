@@ -0,0 +1,16 @@
+#include "Benchmark.h"
+
+#include <cstdlib>
+
+using namespace Pargon;
+
+auto main() -> int
+{
+	auto passed = true;
+
+	RunCommandListBenchmark();
+	passed = RunDrawSortingBenchmark() && passed;
+	passed = RunResourceLockBenchmark() && passed;
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
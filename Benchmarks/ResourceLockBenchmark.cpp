@@ -0,0 +1,174 @@
+#include "Benchmark.h"
+#include "BenchmarkRenderer.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+using namespace Pargon;
+
+namespace
+{
+	constexpr int FrameCount = 200;
+	constexpr int FrameDraws = 10000;
+	constexpr int FramesInFlight = 2;
+
+	struct LoaderResult
+	{
+		double TotalUnlock = 0.0;
+		double MaximumUnlock = 0.0;
+		int Unlocks = 0;
+		int LostUpdates = 0;
+		std::uint32_t LastValue = 0;
+	};
+
+	void WriteValue(Geometry& geometry, std::uint32_t value)
+	{
+		geometry.Reset(GeometryTopology::InstanceData, static_cast<int>(sizeof(std::uint32_t)));
+		*geometry.Reserve<std::uint32_t>(1).Elements.begin() = value;
+	}
+
+	void RecordFrame(GraphicsDevice& device, GeometryId vertices)
+	{
+		for (auto i = 0; i < FrameDraws; i++)
+		{
+			device.SetVertexBuffer(vertices, 12);
+			device.Draw(i % 12, 3);
+		}
+	}
+
+	void RunLoader(Geometry& geometry, std::atomic<bool>& running, std::mutex* deviceGuard, LoaderResult& result)
+	{
+		auto value = std::uint32_t(0);
+
+		while (running.load(std::memory_order_relaxed))
+		{
+			geometry.Lock();
+			WriteValue(geometry, ++value);
+
+			auto start = std::chrono::steady_clock::now();
+
+			if (deviceGuard != nullptr)
+			{
+				std::lock_guard<std::mutex> lock(*deviceGuard);
+				geometry.Unlock();
+			}
+			else
+			{
+				geometry.Unlock();
+			}
+
+			auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			result.TotalUnlock += elapsed;
+			result.MaximumUnlock = std::max(result.MaximumUnlock, elapsed);
+			result.Unlocks++;
+		}
+
+		result.LastValue = value;
+	}
+
+	auto RunLoaders(int loaderCount, bool renderThread, std::mutex* deviceGuard) -> LoaderResult
+	{
+		GraphicsDevice device;
+		SetupBenchmarkDevice(device);
+
+		auto vertices = device.CreateGeometry(GraphicsStorage::CopiedToGpu);
+		vertices->Reset(GeometryTopology::TriangleList, 12 * 12);
+		vertices->Reserve(12, 12);
+		vertices->Unlock();
+
+		List<Geometry*> geometries;
+		List<LoaderResult> results;
+		List<std::thread> loaders;
+		std::atomic<bool> running{ true };
+
+		for (auto i = 0; i < loaderCount; i++)
+		{
+			auto geometry = device.CreateGeometry(GraphicsStorage::CopiedToGpu);
+			WriteValue(*geometry, 0);
+			geometry->Unlock();
+
+			geometries.Add(geometry);
+			results.Add({});
+		}
+
+		if (renderThread)
+			device.StartRenderThread(FramesInFlight);
+
+		for (auto i = 0; i < loaderCount; i++)
+			loaders.Add(std::thread(RunLoader, std::ref(*geometries.Item(i)), std::ref(running), deviceGuard, std::ref(results.Item(i))));
+
+		for (auto frame = 0; frame < FrameCount; frame++)
+		{
+			RecordFrame(device, vertices->Id());
+
+			if (deviceGuard != nullptr)
+			{
+				std::lock_guard<std::mutex> lock(*deviceGuard);
+				device.Render(GraphicsDevice::NoSynchronization);
+			}
+			else
+			{
+				device.Render(GraphicsDevice::NoSynchronization);
+			}
+		}
+
+		running = false;
+
+		for (auto& loader : loaders)
+			loader.join();
+
+		for (auto frame = 0; frame <= FramesInFlight; frame++)
+			device.Render(GraphicsDevice::NoSynchronization);
+
+		device.StopRenderThread();
+
+		LoaderResult total;
+
+		for (auto i = 0; i < loaderCount; i++)
+		{
+			auto& result = results.Item(i);
+			auto handle = geometries.Item(i)->Handle<BenchmarkGeometryHandle>();
+
+			if (geometries.Item(i)->IsChanged() || handle->FirstValue.load() != result.LastValue)
+				total.LostUpdates++;
+
+			total.TotalUnlock += result.TotalUnlock;
+			total.MaximumUnlock = std::max(total.MaximumUnlock, result.MaximumUnlock);
+			total.Unlocks += result.Unlocks;
+		}
+
+		return total;
+	}
+
+	auto PrintResult(const char* name, const LoaderResult& result) -> bool
+	{
+		auto average = result.Unlocks == 0 ? 0.0 : result.TotalUnlock / result.Unlocks * 1000.0;
+		std::printf("   - %-12s %9d unlocks, average %8.3f us, maximum %8.3f ms, %d lost updates\n", name, result.Unlocks, average, result.MaximumUnlock, result.LostUpdates);
+		return result.LostUpdates == 0;
+	}
+}
+
+auto Pargon::RunResourceLockBenchmark() -> bool
+{
+	auto passed = true;
+
+	std::printf("Resource Lock - %d frames of %d draws\n", FrameCount, FrameDraws);
+
+	for (auto loaderCount = 1; loaderCount <= 8; loaderCount *= 2)
+	{
+		std::mutex deviceGuard;
+
+		std::printf(" - %d loader threads\n", loaderCount);
+		passed = PrintResult("device mutex", RunLoaders(loaderCount, false, std::addressof(deviceGuard))) && passed;
+		passed = PrintResult("lock-free", RunLoaders(loaderCount, false, nullptr)) && passed;
+	}
+
+	auto loaderCount = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+
+	std::printf(" - stress, %d loader threads, render thread with %d frames in flight\n", loaderCount, FramesInFlight);
+	passed = PrintResult("lock-free", RunLoaders(loaderCount, true, nullptr)) && passed;
+
+	return passed;
+}
\ No newline at end of file
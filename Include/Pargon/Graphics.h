@@ -1,8 +1,13 @@
 #pragma once
 
+#include "Pargon/Graphics/CommandBundle.h"
+#include "Pargon/Graphics/CommandList.h"
 #include "Pargon/Graphics/Geometry.h"
 #include "Pargon/Graphics/GraphicsDevice.h"
 #include "Pargon/Graphics/GraphicsResource.h"
 #include "Pargon/Graphics/Material.h"
+#include "Pargon/Graphics/MeshOptimizer.h"
 #include "Pargon/Graphics/Renderer.h"
 #include "Pargon/Graphics/Texture.h"
+#include "Pargon/Graphics/VertexFormat.h"
+#include "Pargon/Graphics/VertexPacking.h"
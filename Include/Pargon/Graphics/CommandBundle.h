@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Pargon/Containers/List.h"
+#include "Pargon/Graphics/CommandList.h"
+
+#include <atomic>
+
+namespace Pargon
+{
+	class CommandBundle : private CommandList
+	{
+	public:
+		using CommandList::IsEmpty;
+		using CommandList::Count;
+
+		using CommandList::SetColorTarget;
+		using CommandList::ClearColorTarget;
+		using CommandList::SetDepthStencilTarget;
+		using CommandList::ClearDepthStencilTarget;
+		using CommandList::SetClippingRectangle;
+		using CommandList::SetMaterial;
+		using CommandList::SetTexture;
+		using CommandList::SetVertexBuffer;
+		using CommandList::SetVertexStream;
+		using CommandList::SetInstanceBuffer;
+		using CommandList::SetIndexBuffer;
+		using CommandList::SetConstantBuffer;
+		using CommandList::Draw;
+		using CommandList::SetLayer;
+
+		auto IsValid() const -> bool;
+
+		void Clear();
+
+	private:
+		friend class GraphicsDevice;
+
+		mutable std::atomic<bool> _isValid{ true };
+		mutable unsigned _validatedRevision = 0;
+		mutable List<GeometryTopology> _topologies;
+	};
+}
+
+inline
+auto Pargon::CommandBundle::IsValid() const -> bool
+{
+	return _isValid;
+}
\ No newline at end of file
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "Pargon/Containers/Buffer.h"
+#include "Pargon/Graphics/Geometry.h"
+#include "Pargon/Graphics/Material.h"
+#include "Pargon/Graphics/Texture.h"
+
+#include <cstdint>
+
+namespace Pargon
+{
+	class CommandBundle;
+
+	class CommandList
+	{
+	public:
+		auto IsEmpty() const -> bool;
+		auto Count() const -> int;
+
+		void SetColorTarget(TextureId texture, int slot);
+		void ClearColorTarget(float red, float green, float blue, float alpha);
+		void SetDepthStencilTarget(TextureId texture);
+		void ClearDepthStencilTarget(float depthValue, int stencilValue);
+		void SetClippingRectangle(float x, float y, float width, float height);
+		void SetMaterial(MaterialId material);
+		void SetTexture(TextureId texture, int slot);
+		void SetVertexBuffer(GeometryId geometry, std::size_t vertexSize);
+		void SetVertexStream(GeometryId geometry, std::size_t vertexSize, int stream);
+		void SetInstanceBuffer(GeometryId geometry, std::size_t instanceSize);
+		void SetIndexBuffer(GeometryId geometry, std::size_t indexSize);
+		void SetConstantBuffer(GeometryId geometry, bool vertexAccess, bool fragmentAccess, int start, std::size_t size, int slot);
+		void Draw(int start, int count);
+		void MultiDraw(SequenceView<DrawRange> ranges);
+		void SetLayer(int layer);
+		void Replay(const CommandBundle& bundle);
+
+		void Clear();
+
+	private:
+		friend class CommandListBenchmark;
+		friend class GraphicsDevice;
+
+		enum class RenderCommandType
+		{
+			SetColorTarget,
+			SetDepthStencilTarget,
+			ClearColorTarget,
+			ClearDepthStencilTarget,
+			SetClippingRectangle,
+			SetMaterial,
+			SetTexture,
+			SetVertexBuffer,
+			SetVertexStream,
+			SetInstanceBuffer,
+			SetIndexBuffer,
+			SetConstantBuffer,
+			Draw,
+			MultiDraw,
+			SetLayer,
+			ExecuteCommandList,
+			ExecuteCommandBundle
+		};
+
+		struct RenderCommand
+		{
+			struct SetColorTarget
+			{
+				TextureId Texture;
+				int Slot;
+			};
+
+			struct ClearColorTarget
+			{
+				float R;
+				float G;
+				float B;
+				float A;
+			};
+
+			struct SetDepthStencilTarget
+			{
+				TextureId Texture;
+			};
+
+			struct ClearDepthStencilTarget
+			{
+				float DepthValue;
+				int StencilValue;
+			};
+
+			struct SetClippingRectangle
+			{
+				float X;
+				float Y;
+				float Width;
+				float Height;
+			};
+
+			struct SetMaterial
+			{
+				MaterialId Material;
+			};
+
+			struct SetTexture
+			{
+				TextureId Texture;
+				int Slot;
+			};
+
+			struct SetVertexBuffer
+			{
+				GeometryId Geometry;
+				std::size_t VertexSize;
+			};
+
+			struct SetVertexStream
+			{
+				GeometryId Geometry;
+				std::size_t VertexSize;
+				int Stream;
+			};
+
+			struct SetInstanceBuffer
+			{
+				GeometryId Geometry;
+				std::size_t InstanceSize;
+			};
+
+			struct SetIndexBuffer
+			{
+				GeometryId Geometry;
+				std::size_t IndexSize;
+			};
+
+			struct SetConstantBuffer
+			{
+				GeometryId Geometry;
+				int Start;
+				std::size_t Size;
+				int Slot;
+				bool VertexAccess;
+				bool FragmentAccess;
+			};
+
+			struct Draw
+			{
+				int Start;
+				int Count;
+			};
+
+			struct MultiDraw
+			{
+				int Count;
+				const std::uint8_t* Ranges;
+			};
+
+			struct SetLayer
+			{
+				int Layer;
+			};
+
+			struct ExecuteCommandList
+			{
+				const CommandList* Commands;
+			};
+
+			struct ExecuteCommandBundle
+			{
+				const CommandBundle* Bundle;
+			};
+
+			union Data
+			{
+				Data() {}
+
+				SetColorTarget SetColorTarget;
+				ClearColorTarget ClearColorTarget;
+				SetDepthStencilTarget SetDepthStencilTarget;
+				ClearDepthStencilTarget ClearDepthStencilTarget;
+				SetClippingRectangle SetClippingRectangle;
+				SetMaterial SetMaterial;
+				SetTexture SetTexture;
+				SetVertexBuffer SetVertexBuffer;
+				SetVertexStream SetVertexStream;
+				SetInstanceBuffer SetInstanceBuffer;
+				SetIndexBuffer SetIndexBuffer;
+				SetConstantBuffer SetConstantBuffer;
+				Draw Draw;
+				MultiDraw MultiDraw;
+				SetLayer SetLayer;
+				ExecuteCommandList ExecuteCommandList;
+				ExecuteCommandBundle ExecuteCommandBundle;
+			};
+
+			RenderCommandType Type;
+			Data Data;
+		};
+
+		using EncodedCommand = const std::uint8_t*;
+
+		Buffer _stream;
+		int _size = 0;
+		int _count = 0;
+
+		auto Begin() const -> EncodedCommand;
+		auto End() const -> EncodedCommand;
+
+		static auto GetType(EncodedCommand command) -> RenderCommandType;
+		static auto GetFixedSize(RenderCommandType type) -> int;
+		static auto GetEncodedSize(const RenderCommand& command) -> int;
+		static auto GetEncodedSize(EncodedCommand command) -> int;
+		static auto GetDrawRange(const RenderCommand::MultiDraw& command, int index) -> DrawRange;
+		static auto Next(EncodedCommand command) -> EncodedCommand;
+		static auto Read(EncodedCommand command) -> RenderCommand;
+		static auto IsSame(EncodedCommand left, EncodedCommand right) -> bool;
+		static void Encode(const RenderCommand& command, std::uint8_t* data);
+
+		void Write(const RenderCommand& command);
+		void Append(EncodedCommand command);
+		void Overwrite(int offset, const RenderCommand& command);
+		void ExecuteCommandList(const CommandList& commands);
+	};
+}
+
+inline
+auto Pargon::CommandList::IsEmpty() const -> bool
+{
+	return _count == 0;
+}
+
+inline
+auto Pargon::CommandList::Count() const -> int
+{
+	return _count;
+}
+
+inline
+auto Pargon::CommandList::Begin() const -> EncodedCommand
+{
+	return _stream.begin();
+}
+
+inline
+auto Pargon::CommandList::End() const -> EncodedCommand
+{
+	return _stream.begin() + _size;
+}
+
+inline
+auto Pargon::CommandList::GetType(EncodedCommand command) -> RenderCommandType
+{
+	return static_cast<RenderCommandType>(*command);
+}
+
+inline
+auto Pargon::CommandList::Next(EncodedCommand command) -> EncodedCommand
+{
+	return command + GetEncodedSize(command);
+}
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Pargon/Containers/Buffer.h"
+#include "Pargon/Containers/List.h"
 #include "Pargon/Containers/Sequence.h"
 #include "Pargon/Containers/String.h"
 #include "Pargon/Graphics/GraphicsResource.h"
 
+#include <algorithm>
+
 namespace Pargon
 {
 	class Geometry;
@@ -39,6 +42,21 @@ namespace Pargon
 		SequenceReference<ElementType> Elements;
 	};
 
+	struct GeometryRange
+	{
+		std::size_t Start;
+		std::size_t Size;
+	};
+
+	struct DrawRange
+	{
+		int FirstIndex;
+		int IndexCount;
+		int BaseVertex;
+		int FirstInstance;
+		int InstanceCount;
+	};
+
 	class Geometry : public GraphicsResource<Geometry>
 	{
 	public:
@@ -54,10 +72,17 @@ namespace Pargon
 		auto Topology() const -> GeometryTopology;
 		auto Data() const -> BufferView;
 		auto Size() const -> std::size_t;
+		auto IsMapped() const -> bool;
+		auto IsAdopted() const -> bool;
+		auto IsFullyChanged() const -> bool;
+		auto ChangedRanges() const -> SequenceView<GeometryRange>;
 
 		void Reset(GeometryTopology topology, int capacity);
 		template<typename ElementType> auto Reset(GeometryTopology topology, SequenceView<ElementType> elements) -> GeometryReservation<ElementType>;
 
+		void Adopt(GeometryTopology topology, BufferView data);
+		template<typename ElementType> void Adopt(GeometryTopology topology, SequenceView<ElementType> elements);
+
 		auto GetStart(std::size_t size) const -> int;
 		template<typename ElementType> auto GetStart() const -> int;
 
@@ -65,11 +90,19 @@ namespace Pargon
 		template<typename ElementType> auto Reserve(int count) -> GeometryReservation<ElementType>;
 		template<typename ElementType> auto Reserve(SequenceView<ElementType> elements) -> GeometryReservation<ElementType>;
 
+		auto ReserveParallel(std::size_t size, int count) -> Reservation;
+		template<typename ElementType> auto ReserveParallel(int count) -> GeometryReservation<ElementType>;
+
 		auto Retreive(std::size_t size, int offset, int count) -> Reservation;
 		template<typename ElementType> auto Retreive(int start, int count) -> GeometryReservation<ElementType>;
 
 	protected:
 		void Clear() override;
+		void ClearChanges() override;
+		auto HashContents() const -> std::uint64_t override;
+		auto ContentSize() const -> std::size_t override;
+		auto CreateSnapshot() const -> std::unique_ptr<GraphicsResource_> override;
+		void CopyContents(GraphicsResource_& snapshot, bool pending) const override;
 
 	private:
 		friend class GraphicsDevice;
@@ -77,12 +110,21 @@ namespace Pargon
 
 		static constexpr std::size_t _constantDataAlignment = 256;
 		static constexpr std::size_t _constantDataOffset = 16;
+		static constexpr int _maximumChangedRanges = 16;
 
 		GeometryTopology _topology = GeometryTopology::Unknown;
 		Buffer _data;
-		std::size_t _size = 0;
+		BufferReference _mapped;
+		BufferView _adopted;
+		std::atomic<std::size_t> _size{ 0 };
+
+		std::atomic<bool> _isFullyChanged{ true };
+		List<GeometryRange> _changedRanges;
 
 		void ValidateReservation(std::size_t size, int count);
+		void Detach();
+		auto GetReference(int location, int size) -> BufferReference;
+		void MarkChanged(std::size_t start, std::size_t size);
 	};
 }
 
@@ -95,13 +137,40 @@ auto Pargon::Geometry::Topology() const -> GeometryTopology
 inline
 auto Pargon::Geometry::Data() const -> BufferView
 {
-	return _data;
+	auto data = IsMapped() ? _mapped.begin() : IsAdopted() ? _adopted.begin() : _data.begin();
+	auto extent = IsMapped() ? _mapped.Size() : IsAdopted() ? _adopted.Size() : _data.Size();
+
+	return { data, std::min(static_cast<int>(Size()), extent) };
 }
 
 inline
 auto Pargon::Geometry::Size() const -> std::size_t
 {
-	return _size;
+	return _size.load(std::memory_order_relaxed);
+}
+
+inline
+auto Pargon::Geometry::IsMapped() const -> bool
+{
+	return _mapped.begin() != nullptr;
+}
+
+inline
+auto Pargon::Geometry::IsAdopted() const -> bool
+{
+	return _adopted.begin() != nullptr;
+}
+
+inline
+auto Pargon::Geometry::IsFullyChanged() const -> bool
+{
+	return _isFullyChanged.load(std::memory_order_relaxed);
+}
+
+inline
+auto Pargon::Geometry::ChangedRanges() const -> SequenceView<GeometryRange>
+{
+	return _changedRanges;
 }
 
 template<typename ElementType>
@@ -111,6 +180,12 @@ auto Pargon::Geometry::Reset(GeometryTopology topology, SequenceView<ElementType
 	return Reserve<ElementType>(elements);
 }
 
+template<typename ElementType>
+void Pargon::Geometry::Adopt(GeometryTopology topology, SequenceView<ElementType> elements)
+{
+	Adopt(topology, { reinterpret_cast<const std::uint8_t*>(elements.begin()), static_cast<int>(elements.Count() * sizeof(ElementType)) });
+}
+
 template<typename ElementType>
 auto Pargon::Geometry::GetStart() const -> int
 {
@@ -132,6 +207,13 @@ auto Pargon::Geometry::Reserve(SequenceView<ElementType> elements) -> GeometryRe
 	return reservation;
 }
 
+template<typename ElementType>
+auto Pargon::Geometry::ReserveParallel(int count) -> GeometryReservation<ElementType>
+{
+	auto reservation = ReserveParallel(sizeof(ElementType), count);
+	return { Id(), reservation.Offset, reservation.ElementCount, reservation.ElementSize, { reinterpret_cast<ElementType*>(reservation.Buffer.begin()), reservation.ElementCount } };
+}
+
 template<typename ElementType>
 auto Pargon::Geometry::Retreive(int offset, int count) -> GeometryReservation<ElementType>
 {
@@ -1,21 +1,44 @@
 #pragma once
 
 #include "Pargon/Application/Application.h"
-#include "Pargon/Containers/Map.h"
+#include "Pargon/Containers/Array.h"
+#include "Pargon/Containers/Buffer.h"
+#include "Pargon/Graphics/CommandBundle.h"
+#include "Pargon/Graphics/CommandList.h"
 #include "Pargon/Graphics/Geometry.h"
 #include "Pargon/Graphics/GraphicsResource.h"
+#include "Pargon/Graphics/GraphicsResourceTable.h"
 #include "Pargon/Graphics/Material.h"
 #include "Pargon/Graphics/Renderer.h"
 #include "Pargon/Graphics/Texture.h"
 #include "Pargon/Types/Color.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 namespace Pargon
 {
 	class Color;
 
+	struct GraphicsStatistics
+	{
+		int RecordedCommands;
+		int ExecutedCommands;
+		int RedundantCommands;
+		int OverwrittenClears;
+		int MergedDraws;
+		int InvalidBundles;
+		int InstancedDraws;
+		int SkippedDraws;
+		std::size_t SkippedUploadBytes;
+		std::size_t UploadedBytes;
+		std::size_t QueuedUploadBytes;
+		int QueuedUploads;
+	};
+
 	class GraphicsDevice
 	{
 	public:
@@ -27,17 +50,42 @@ namespace Pargon
 		static constexpr std::size_t ActualSize = 0;
 		static constexpr int NoSynchronization = 0;
 		static constexpr int VSync = 1;
+		static constexpr int InstancingDisabled = -1;
+		static constexpr std::size_t UnlimitedUploadBytes = 0;
+		static constexpr double UnlimitedUploadTime = 0.0;
+		static constexpr int PoolingDisabled = 0;
+
+		~GraphicsDevice();
 
 		auto Renderer() const -> Renderer*;
 		auto Geometries() const -> SequenceView<std::unique_ptr<Geometry>>;
 		auto Materials() const -> SequenceView<std::unique_ptr<Material>>;
 		auto Textures() const -> SequenceView<std::unique_ptr<Texture>>;
+		auto DrawSorting() const -> bool;
+		auto CommandOptimization() const -> bool;
+		auto AutomaticInstancing() const -> int;
+		auto UploadElision() const -> bool;
+		auto UploadByteBudget() const -> std::size_t;
+		auto UploadTimeBudget() const -> double;
+		auto PoolLimit() const -> int;
+		auto Statistics() const -> const GraphicsStatistics&;
+		auto FramesInFlight() const -> int;
 
 		auto Setup(Application& application, std::unique_ptr<Pargon::Renderer>&& renderer) -> RendererInformation;
+		void SetDrawSorting(bool enabled);
+		void SetCommandOptimization(bool enabled);
+		void SetAutomaticInstancing(int constantBufferSlot);
+		void SetUploadElision(bool enabled);
+		void SetUploadBudget(std::size_t bytes, double milliseconds);
+		void SetPoolLimit(int count);
+		void StartRenderThread(int framesInFlight);
+		void StopRenderThread();
 
 		auto CreateGeometry(GraphicsStorage storage) -> Geometry*;
+		auto CreateGeometry(GraphicsStorage storage, GeometryTopology topology, int capacity) -> Geometry*;
 		auto CreateMaterial(GraphicsStorage storage) -> Material*;
 		auto CreateTexture(GraphicsStorage storage) -> Texture*;
+		auto CreateTexture(GraphicsStorage storage, TextureSize size, TextureFormat format) -> Texture*;
 		auto GetGeometry(GeometryId id) -> Geometry*;
 		auto GetMaterial(MaterialId id) -> Material*;
 		auto GetTexture(TextureId id) -> Texture*;
@@ -45,6 +93,8 @@ namespace Pargon
 		void DestroyMaterial(MaterialId id);
 		void DestroyTexture(TextureId id);
 
+		template<typename ElementType> auto ReserveTransient(GeometryTopology topology, int count) -> GeometryReservation<ElementType>;
+
 		void SetColorTarget(TextureId texture, int slot);
 		void ClearColorTarget(float red, float green, float blue, float alpha);
 		void SetDepthStencilTarget(TextureId texture);
@@ -53,164 +103,251 @@ namespace Pargon
 		void SetMaterial(MaterialId material);
 		void SetTexture(TextureId texture, int slot);
 		void SetVertexBuffer(GeometryId geometry, std::size_t vertexSize);
+		void SetVertexStream(GeometryId geometry, std::size_t vertexSize, int stream);
 		void SetInstanceBuffer(GeometryId geometry, std::size_t instanceSize);
 		void SetIndexBuffer(GeometryId geometry, std::size_t indexSize);
 		void SetConstantBuffer(GeometryId geometry, bool vertexAccess, bool fragmentAccess, int start, std::size_t size, int slot);
 		void Draw(int start, int count);
+		void MultiDraw(SequenceView<DrawRange> ranges);
+		void SetLayer(int layer);
+		void Replay(const CommandBundle& bundle);
+		void Submit(CommandList& commands);
 
 		void Render(int synchronization);
 
 	private:
 		friend class GraphicsResource_;
 
-		enum class RenderCommandType
+		using RenderCommand = CommandList::RenderCommand;
+		using RenderCommandType = CommandList::RenderCommandType;
+		using EncodedCommand = CommandList::EncodedCommand;
+
+		static constexpr int _sortedSlotCount = 8;
+		static constexpr int _stopFrame = -1;
+		static constexpr int _topologyCount = static_cast<int>(GeometryTopology::ConstantData) + 1;
+
+		using TransientGeometries = Array<Geometry*, _topologyCount>;
+
+		struct RetiredResources
 		{
-			SetColorTarget,
-			SetDepthStencilTarget,
-			ClearColorTarget,
-			ClearDepthStencilTarget,
-			SetClippingRectangle,
-			SetMaterial,
-			SetTexture,
-			SetVertexBuffer,
-			SetInstanceBuffer,
-			SetIndexBuffer,
-			SetConstantBuffer,
-			Draw
+			List<GeometryId> Geometries;
+			List<MaterialId> Materials;
+			List<TextureId> Textures;
 		};
 
-		struct RenderCommand
+		struct GeometryPool
 		{
-			struct SetColorTarget
-			{
-				TextureId Texture;
-				int Slot;
-			};
-
-			struct ClearColorTarget
-			{
-				float R;
-				float G;
-				float B;
-				float A;
-			};
-
-			struct SetDepthStencilTarget
-			{
-				TextureId Texture;
-			};
-
-			struct ClearDepthStencilTarget
-			{
-				float DepthValue;
-				int StencilValue;
-			};
-
-			struct SetClippingRectangle
-			{
-				float X;
-				float Y;
-				float Width;
-				float Height;
-			};
-
-			struct SetMaterial
-			{
-				MaterialId Material;
-			};
-
-			struct SetTexture
-			{
-				TextureId Texture;
-				int Slot;
-			};
-
-			struct SetVertexBuffer
-			{
-				GeometryId Geometry;
-				std::size_t VertexSize;
-			};
-
-			struct SetInstanceBuffer
-			{
-				GeometryId Geometry;
-				std::size_t InstanceSize;
-			};
-
-			struct SetIndexBuffer
-			{
-				GeometryId Geometry;
-				std::size_t IndexSize;
-			};
-
-			struct SetConstantBuffer
-			{
-				GeometryId Geometry;
-				int Start;
-				std::size_t Size;
-				int Slot;
-				bool VertexAccess;
-				bool FragmentAccess;
-			};
-
-			struct Draw
-			{
-				int Start;
-				int Count;
-			};
-
-			union Data
-			{
-				Data() {}
-
-				SetColorTarget SetColorTarget;
-				ClearColorTarget ClearColorTarget;
-				SetDepthStencilTarget SetDepthStencilTarget;
-				ClearDepthStencilTarget ClearDepthStencilTarget;
-				SetClippingRectangle SetClippingRectangle;
-				SetMaterial SetMaterial;
-				SetTexture SetTexture;
-				SetVertexBuffer SetVertexBuffer;
-				SetInstanceBuffer SetInstanceBuffer;
-				SetIndexBuffer SetIndexBuffer;
-				SetConstantBuffer SetConstantBuffer;
-				Draw Draw;
-			};
-
-			RenderCommandType Type;
-			Data Data;
+			GraphicsStorage Storage;
+			int CapacityClass;
+			List<std::unique_ptr<Geometry>> Geometries;
 		};
 
-		std::unique_ptr<Pargon::Renderer> _renderer;
-		std::mutex _resourceGuard;
+		struct TexturePool
+		{
+			GraphicsStorage Storage;
+			TextureSize Size;
+			TextureFormat Format;
+			List<std::unique_ptr<Texture>> Textures;
+		};
 
-		int _nextGeometryId = 0;
-		int _nextMaterialId = 0;
-		int _nextTextureId = 0;
+		class FrameQueue
+		{
+		public:
+			void Reset(int capacity);
+			void Push(int frame);
+			auto Pop() -> int;
+
+		private:
+			List<int> _frames;
+			std::atomic<int> _head{ 0 };
+			std::atomic<int> _tail{ 0 };
+			std::mutex _signalGuard;
+			std::condition_variable _signal;
+		};
 
-		Map<int, std::unique_ptr<Geometry>> _geometries;
-		Map<int, std::unique_ptr<Material>> _materials;
-		Map<int, std::unique_ptr<Texture>> _textures;
+		struct CapturedConstants
+		{
+			GeometryId Geometry;
+			int Start;
+			std::size_t Size;
+			int Offset;
+		};
 
-		List<GraphicsResource_*> _pendingUpdates;
-		List<RenderCommand> _commandQueue;
+		struct Frame
+		{
+			CommandList Commands;
+			List<std::unique_ptr<CommandList>> SubmittedCommands;
+			List<GraphicsResource_*> PendingUpdates;
+			TransientGeometries Transients = {{ nullptr }};
+			List<CapturedConstants> InstanceConstants;
+			Buffer InstanceData;
+			int InstanceDataSize = 0;
+			RetiredResources Retired;
+			GraphicsStatistics Statistics = {};
+			int RecordedCommands = 0;
+			std::size_t SkippedUploadBytes = 0;
+			int Synchronization = 0;
+			bool DrawSorting = false;
+			bool CommandOptimization = false;
+			int AutomaticInstancing = InstancingDisabled;
+			std::size_t UploadByteBudget = UnlimitedUploadBytes;
+			double UploadTimeBudget = UnlimitedUploadTime;
+			bool Completed = false;
+		};
+
+		struct DrawState
+		{
+			int Material;
+			int ClippingRectangle;
+			int VertexBuffer;
+			int InstanceBuffer;
+			int IndexBuffer;
+			Array<int, MaximumVertexStreams> VertexStreams;
+			Array<int, _sortedSlotCount> Textures;
+			Array<int, _sortedSlotCount> ConstantBuffers;
+		};
+
+		struct DrawPacket
+		{
+			std::uint64_t Key;
+			int Draw;
+			int State;
+		};
+
+		struct BoundState
+		{
+			EncodedCommand Material;
+			EncodedCommand ClippingRectangle;
+			EncodedCommand VertexBuffer;
+			EncodedCommand InstanceBuffer;
+			EncodedCommand IndexBuffer;
+			Array<EncodedCommand, MaximumVertexStreams> VertexStreams;
+			EncodedCommand DepthStencilTarget;
+			EncodedCommand ColorClear;
+			EncodedCommand DepthStencilClear;
+			List<EncodedCommand> ColorTargets;
+			List<EncodedCommand> Textures;
+			List<EncodedCommand> ConstantBuffers;
+			int LastDraw;
+		};
+
+		std::unique_ptr<Pargon::Renderer> _renderer;
+		std::mutex _resourceGuard;
+
+		GraphicsResourceTable<Geometry> _geometries;
+		GraphicsResourceTable<Material> _materials;
+		GraphicsResourceTable<Texture> _textures;
+		std::atomic<unsigned> _resourceRevision{ 1 };
+
+		std::mutex _retireGuard;
+		RetiredResources _retired;
+		List<std::unique_ptr<GraphicsResource_>> _releasedResources;
+
+		int _poolLimit = PoolingDisabled;
+		List<GeometryPool> _geometryPools;
+		List<TexturePool> _texturePools;
+
+		std::atomic<GraphicsResource_*> _pendingUpdates{ nullptr };
+		std::atomic<bool> _uploadElision{ false };
+		std::atomic<std::size_t> _skippedUploadBytes{ 0 };
+		std::size_t _uploadByteBudget = UnlimitedUploadBytes;
+		double _uploadTimeBudget = UnlimitedUploadTime;
+		List<GraphicsResource_*> _uploadQueue;
+		CommandList _commandQueue;
+		List<CommandList*> _submittedCommands;
+		TransientGeometries _transients = {{ nullptr }};
+
+		std::thread _renderThread;
+		int _framesInFlight = 0;
+		List<std::unique_ptr<Frame>> _frames;
+		FrameQueue _availableFrames;
+		FrameQueue _submittedFrames;
+
+		bool _drawSorting = false;
+		List<EncodedCommand> _frameCommands;
+		List<DrawState> _drawStates;
+		List<DrawPacket> _drawPackets;
+		List<DrawPacket> _sortScratch;
+		CommandList _sortedQueue;
+
+		bool _commandOptimization = true;
+		BoundState _boundState;
+		CommandList _optimizedQueue;
+		GraphicsStatistics _statistics = {};
+		GraphicsStatistics _frameStatistics = {};
+
+		List<RenderPacket> _renderPackets;
+		List<DrawRange> _drawRanges;
+
+		int _automaticInstancing = InstancingDisabled;
+		int _instancingSlot = InstancingDisabled;
+		const Frame* _instancingFrame = nullptr;
+		std::unique_ptr<Geometry> _instanceGeometry;
+		std::size_t _instanceSize = 0;
+		RenderCommand::SetConstantBuffer _instanceConstants;
+		bool _hasInstanceConstants = false;
+		bool _instanceConstantsPending = false;
+		int _instancedDraw = -1;
 
 		int _vertexCount = 0;
 		int _instanceCount = 0;
 		int _indexCount = 0;
 
-		void ExecuteCommand(const RenderCommand::SetColorTarget& command);
-		void ExecuteCommand(const RenderCommand::ClearColorTarget& command);
-		void ExecuteCommand(const RenderCommand::SetDepthStencilTarget& command);
-		void ExecuteCommand(const RenderCommand::ClearDepthStencilTarget& command);
-		void ExecuteCommand(const RenderCommand::SetClippingRectangle& command);
-		void ExecuteCommand(const RenderCommand::SetMaterial& command);
-		void ExecuteCommand(const RenderCommand::SetTexture& command);
-		void ExecuteCommand(const RenderCommand::SetVertexBuffer& command);
-		void ExecuteCommand(const RenderCommand::SetInstanceBuffer& command);
-		void ExecuteCommand(const RenderCommand::SetIndexBuffer& command);
-		void ExecuteCommand(const RenderCommand::SetConstantBuffer& command);
-		void ExecuteCommand(const RenderCommand::Draw& command);
+		void QueueUpdate(GraphicsResource_* resource);
+		void TakeUpdates(List<GraphicsResource_*>& updates);
+		void ProcessUploads(const Frame& frame);
+
+		auto GetTransientGeometry(GeometryTopology topology) -> Geometry*;
+
+		void ReleaseRetired(Frame& frame);
+		auto GetGeometryPool(GraphicsStorage storage, int capacityClass, bool create) -> GeometryPool*;
+		auto GetTexturePool(GraphicsStorage storage, TextureSize size, TextureFormat format, bool create) -> TexturePool*;
+		void PoolGeometry(std::unique_ptr<Geometry>&& geometry);
+		void PoolTexture(std::unique_ptr<Texture>&& texture);
+		void PrepareFrame(Frame& frame, int synchronization);
+		void ProcessFrame(Frame& frame);
+		void RenderFrames();
+
+		void FlattenCommands(const CommandList& commands);
+		void SortCommands(const CommandList& commands);
+		void FlushDrawPackets(DrawState& emitted);
+		void EmitDrawState(const DrawState& state, DrawState& emitted);
+
+		void OptimizeCommands(const CommandList& commands);
+		void OptimizeCommand(EncodedCommand command);
+		void EmitOptimizedCommand(EncodedCommand command);
+		void FlushClears();
+		auto IsBound(EncodedCommand bound, EncodedCommand command) const -> bool;
+		auto CanMergeDraws(const RenderCommand::Draw& previous, const RenderCommand::Draw& next) -> bool;
+
+		auto ValidateBundle(const CommandBundle& bundle) -> bool;
+
+		template<typename ResourceType> static auto GetHandle(ResourceType* resource) -> GraphicsHandle<ResourceType>*;
+
+		void TranslateCommands(const CommandList& commands);
+		void TranslateCommand(const RenderCommand::SetColorTarget& command);
+		void TranslateCommand(const RenderCommand::ClearColorTarget& command);
+		void TranslateCommand(const RenderCommand::SetDepthStencilTarget& command);
+		void TranslateCommand(const RenderCommand::ClearDepthStencilTarget& command);
+		void TranslateCommand(const RenderCommand::SetClippingRectangle& command);
+		void TranslateCommand(const RenderCommand::SetMaterial& command);
+		void TranslateCommand(const RenderCommand::SetTexture& command);
+		void TranslateCommand(const RenderCommand::SetVertexBuffer& command);
+		void TranslateCommand(const RenderCommand::SetVertexStream& command);
+		void TranslateCommand(const RenderCommand::SetInstanceBuffer& command);
+		void TranslateCommand(const RenderCommand::SetIndexBuffer& command);
+		void TranslateCommand(const RenderCommand::SetConstantBuffer& command);
+		void TranslateCommand(const RenderCommand::Draw& command);
+		void TranslateCommand(const RenderCommand::MultiDraw& command);
+		void ResolveDrawRanges();
+		void EmitConstantBuffer(const RenderCommand::SetConstantBuffer& command);
+
+		void CaptureInstanceConstants(const CommandList& commands, Frame& frame);
+		void ResetInstancing(const Frame& frame);
+		auto FindInstanceConstants(const RenderCommand::SetConstantBuffer& command) const -> const std::uint8_t*;
+		auto TranslateInstancedDraw(const RenderCommand::Draw& command) -> bool;
+		void FlushInstanceConstants();
+		void UploadInstances();
 	};
 }
 
@@ -237,3 +374,63 @@ auto Pargon::GraphicsDevice::Textures() const -> SequenceView<std::unique_ptr<Te
 {
 	return _textures.Items();
 }
+
+inline
+auto Pargon::GraphicsDevice::DrawSorting() const -> bool
+{
+	return _drawSorting;
+}
+
+inline
+auto Pargon::GraphicsDevice::CommandOptimization() const -> bool
+{
+	return _commandOptimization;
+}
+
+inline
+auto Pargon::GraphicsDevice::AutomaticInstancing() const -> int
+{
+	return _automaticInstancing;
+}
+
+inline
+auto Pargon::GraphicsDevice::UploadElision() const -> bool
+{
+	return _uploadElision;
+}
+
+inline
+auto Pargon::GraphicsDevice::UploadByteBudget() const -> std::size_t
+{
+	return _uploadByteBudget;
+}
+
+inline
+auto Pargon::GraphicsDevice::UploadTimeBudget() const -> double
+{
+	return _uploadTimeBudget;
+}
+
+inline
+auto Pargon::GraphicsDevice::PoolLimit() const -> int
+{
+	return _poolLimit;
+}
+
+template<typename ElementType>
+auto Pargon::GraphicsDevice::ReserveTransient(GeometryTopology topology, int count) -> GeometryReservation<ElementType>
+{
+	return GetTransientGeometry(topology)->Reserve<ElementType>(count);
+}
+
+inline
+auto Pargon::GraphicsDevice::Statistics() const -> const GraphicsStatistics&
+{
+	return _statistics;
+}
+
+inline
+auto Pargon::GraphicsDevice::FramesInFlight() const -> int
+{
+	return _framesInFlight;
+}
@@ -1,17 +1,22 @@
 #pragma once
 
 #include "Pargon/Containers/Array.h"
+#include "Pargon/Containers/Buffer.h"
 #include "Pargon/Containers/Sequence.h"
 #include "Pargon/Containers/String.h"
 #include "Pargon/Serialization/Serialization.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 
 namespace Pargon
 {
+	class CommandList;
 	class GraphicsDevice;
 	class GraphicsResource_;
+	template<typename ResourceType> class GraphicsResourceTable;
 
 	enum class GraphicsStorage
 	{
@@ -19,7 +24,9 @@ namespace Pargon
 		CopiedToGpu,
 		StreamedToGpu,
 		TransferredToGpu,
-		GpuOnly
+		GpuOnly,
+		FrameTransient,
+		MappedToGpu
 	};
 
 	class GraphicsHandle_
@@ -37,8 +44,11 @@ namespace Pargon
 	class GraphicsHandle : public GraphicsHandle_
 	{
 	protected:
+		friend ResourceType;
+
 		auto Update(GraphicsResource_* resource) -> bool override;
 		virtual auto Update(ResourceType* resource) -> bool = 0;
+		virtual auto Map(ResourceType* resource, std::size_t capacity) -> BufferReference;
 	};
 
 	class GraphicsResource_
@@ -52,25 +62,57 @@ namespace Pargon
 
 		auto IsLocked() const -> bool;
 		auto IsChanged() const -> bool;
+		auto UploadPriority() const -> int;
+		auto IsDoubleBuffered() const -> bool;
 
 		void Lock();
 		void Unlock();
+		void SetUploadPriority(int priority);
+		void SetDoubleBuffered(bool enabled);
 
 	protected:
 		GraphicsResource_(GraphicsDevice& graphics, GraphicsStorage storage, std::unique_ptr<GraphicsHandle_>&& handle);
 
 		void UpdateComplete();
+		void Recycle();
+		void InvalidateCommandBundles();
 		virtual void Clear() = 0;
+		virtual void ClearChanges();
+		virtual auto HashContents() const -> std::uint64_t;
+		virtual auto ContentSize() const -> std::size_t;
+		virtual auto CreateSnapshot() const -> std::unique_ptr<GraphicsResource_>;
+		virtual void CopyContents(GraphicsResource_& snapshot, bool pending) const;
+
+		static auto HashBytes(BufferView bytes, std::uint64_t seed) -> std::uint64_t;
 
 	private:
 		friend class GraphicsDevice;
 
+		static constexpr unsigned _lockedState = 0x1;
+		static constexpr unsigned _changedState = 0x2;
+		static constexpr unsigned _uploadingState = 0x4;
+		static constexpr unsigned _retiredState = 0x8;
+		static constexpr unsigned _publishingState = 0x10;
+		static constexpr unsigned _staleState = 0x20;
+
 		GraphicsDevice& _graphics;
 		GraphicsStorage _storage;
 		std::unique_ptr<GraphicsHandle_> _handle;
+		std::unique_ptr<GraphicsResource_> _snapshot;
+
+		std::atomic<unsigned> _state;
+		std::atomic<int> _uploadPriority{ 0 };
+		GraphicsResource_* _nextUpdate = nullptr;
+
+		std::uint64_t _contentHash = 0;
+		std::atomic<std::uint64_t> _uploadedHash{ 0 };
+		std::size_t _uploadedSize = 0;
 
-		bool _isLocked;
-		bool _isChanged;
+		auto BeginUpdate() -> bool;
+		auto UploadSource() -> GraphicsResource_*;
+		auto IsRetired() const -> bool;
+		void Retire();
+		void Publish(bool writer);
 	};
 
 	template<typename ResourceType>
@@ -87,7 +129,14 @@ namespace Pargon
 		auto Assignment() const -> int;
 
 	private:
+		friend class CommandList;
 		friend class GraphicsDevice;
+		friend class GraphicsResourceTable<ResourceType>;
+
+		static constexpr int _indexBits = 20;
+		static constexpr int _indexMask = (1 << _indexBits) - 1;
+		static constexpr int _generationMask = (1 << (31 - _indexBits)) - 1;
+
 		GraphicsId(int id);
 		int _id = -1;
 	};
@@ -104,8 +153,12 @@ namespace Pargon
 		GraphicsResource(GraphicsDevice& graphics, GraphicsStorage storage, std::unique_ptr<GraphicsHandle_>&& handle, GraphicsId<ResourceType> id);
 
 	private:
+		friend class GraphicsDevice;
+
 		GraphicsId<ResourceType> _id;
 		String _name;
+
+		void Recycle(GraphicsId<ResourceType> id);
 	};
 }
 
@@ -115,6 +168,12 @@ auto Pargon::GraphicsHandle<ResourceType>::Update(GraphicsResource_* resource) -
 	return Update(static_cast<ResourceType*>(resource));
 }
 
+template<typename ResourceType>
+auto Pargon::GraphicsHandle<ResourceType>::Map(ResourceType* resource, std::size_t capacity) -> BufferReference
+{
+	return {};
+}
+
 inline
 auto Pargon::GraphicsResource_::Graphics() const -> GraphicsDevice&
 {
@@ -136,13 +195,37 @@ auto Pargon::GraphicsResource_::Handle() const -> HandleType*
 inline
 auto Pargon::GraphicsResource_::IsLocked() const -> bool
 {
-	return _isLocked;
+	return (_state.load(std::memory_order_acquire) & _lockedState) != 0;
 }
 
 inline
 auto Pargon::GraphicsResource_::IsChanged() const -> bool
 {
-	return _isChanged;
+	return (_state.load(std::memory_order_acquire) & _changedState) != 0;
+}
+
+inline
+auto Pargon::GraphicsResource_::IsDoubleBuffered() const -> bool
+{
+	return _snapshot != nullptr;
+}
+
+inline
+auto Pargon::GraphicsResource_::UploadSource() -> GraphicsResource_*
+{
+	return _snapshot ? _snapshot.get() : this;
+}
+
+inline
+auto Pargon::GraphicsResource_::UploadPriority() const -> int
+{
+	return _uploadPriority.load(std::memory_order_relaxed);
+}
+
+inline
+void Pargon::GraphicsResource_::SetUploadPriority(int priority)
+{
+	_uploadPriority.store(priority, std::memory_order_relaxed);
 }
 
 template<typename ResourceType>
@@ -199,6 +282,15 @@ void Pargon::GraphicsResource<ResourceType>::SetName(StringView name)
 	_name = name;
 }
 
+template<typename ResourceType>
+void Pargon::GraphicsResource<ResourceType>::Recycle(GraphicsId<ResourceType> id)
+{
+	GraphicsResource_::Recycle();
+
+	_id = id;
+	_name = String();
+}
+
 template<typename ResourceType>
 Pargon::GraphicsResource<ResourceType>::GraphicsResource(GraphicsDevice& graphics, GraphicsStorage storage, std::unique_ptr<GraphicsHandle_>&& handle, GraphicsId<ResourceType> id) : GraphicsResource_(graphics, storage, std::move(handle)),
 	_id(id)
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Pargon/Containers/List.h"
+#include "Pargon/Containers/Sequence.h"
+#include "Pargon/Graphics/GraphicsResource.h"
+
+#include <memory>
+
+namespace Pargon
+{
+	template<typename ResourceType>
+	class GraphicsResourceTable
+	{
+	public:
+		auto Items() const -> SequenceView<std::unique_ptr<ResourceType>>;
+
+		template<typename FactoryType> auto Create(FactoryType&& factory) -> ResourceType*;
+		auto Get(GraphicsId<ResourceType> id) const -> ResourceType*;
+		auto Remove(GraphicsId<ResourceType> id) -> std::unique_ptr<ResourceType>;
+
+	private:
+		struct Slot
+		{
+			int Generation;
+			int Item;
+		};
+
+		List<Slot> _slots;
+		List<int> _freeSlots;
+		List<int> _itemSlots;
+		List<std::unique_ptr<ResourceType>> _items;
+
+		auto GetSlot(GraphicsId<ResourceType> id) const -> int;
+	};
+}
+
+template<typename ResourceType>
+auto Pargon::GraphicsResourceTable<ResourceType>::Items() const -> SequenceView<std::unique_ptr<ResourceType>>
+{
+	return _items;
+}
+
+template<typename ResourceType>
+template<typename FactoryType>
+auto Pargon::GraphicsResourceTable<ResourceType>::Create(FactoryType&& factory) -> ResourceType*
+{
+	auto index = 0;
+
+	if (_freeSlots.IsEmpty())
+	{
+		index = _slots.Count();
+		_slots.Add({ 0, -1 });
+	}
+	else
+	{
+		index = _freeSlots.Last();
+		_freeSlots.RemoveAt(_freeSlots.Count() - 1);
+	}
+
+	assert(index <= GraphicsId<ResourceType>::_indexMask);
+
+	auto& slot = _slots.Item(index);
+	auto id = GraphicsId<ResourceType>((slot.Generation << GraphicsId<ResourceType>::_indexBits) | index);
+
+	slot.Item = _items.Count();
+	_itemSlots.Add(index);
+
+	return _items.Add(factory(id)).get();
+}
+
+template<typename ResourceType>
+auto Pargon::GraphicsResourceTable<ResourceType>::Get(GraphicsId<ResourceType> id) const -> ResourceType*
+{
+	auto index = GetSlot(id);
+	return index == Sequence::InvalidIndex ? nullptr : _items.Item(_slots.Item(index).Item).get();
+}
+
+template<typename ResourceType>
+auto Pargon::GraphicsResourceTable<ResourceType>::Remove(GraphicsId<ResourceType> id) -> std::unique_ptr<ResourceType>
+{
+	auto index = GetSlot(id);
+
+	if (index == Sequence::InvalidIndex)
+		return nullptr;
+
+	auto& slot = _slots.Item(index);
+	auto item = slot.Item;
+	auto last = _items.Count() - 1;
+	auto resource = std::move(_items.Item(item));
+
+	if (item != last)
+	{
+		_items.Item(item) = std::move(_items.Item(last));
+		_itemSlots.Item(item) = _itemSlots.Item(last);
+		_slots.Item(_itemSlots.Item(item)).Item = item;
+	}
+
+	_items.RemoveAt(last);
+	_itemSlots.RemoveAt(last);
+
+	slot.Generation = (slot.Generation + 1) & GraphicsId<ResourceType>::_generationMask;
+	slot.Item = -1;
+	_freeSlots.Add(index);
+
+	return resource;
+}
+
+template<typename ResourceType>
+auto Pargon::GraphicsResourceTable<ResourceType>::GetSlot(GraphicsId<ResourceType> id) const -> int
+{
+	if (!id.IsAssigned())
+		return Sequence::InvalidIndex;
+
+	auto index = id._id & GraphicsId<ResourceType>::_indexMask;
+	auto generation = id._id >> GraphicsId<ResourceType>::_indexBits;
+
+	if (index >= _slots.Count())
+		return Sequence::InvalidIndex;
+
+	auto& slot = _slots.Item(index);
+	return slot.Item == -1 || slot.Generation != generation ? Sequence::InvalidIndex : index;
+}
\ No newline at end of file
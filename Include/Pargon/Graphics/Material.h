@@ -6,6 +6,8 @@
 #include "Pargon/Graphics/GraphicsResource.h"
 #include "Pargon/Serialization/Serializer.h"
 
+#include <cstdint>
+
 namespace Pargon
 {
 	class Log;
@@ -31,7 +33,14 @@ namespace Pargon
 		Matrix4x4,
 		Color,
 		Texture,
-		Sampler
+		Sampler,
+		Half2,
+		Half4,
+		SignedNormal2x16,
+		SignedNormal4x16,
+		UnsignedNormal2x16,
+		UnsignedNormal4x16,
+		UnsignedNormal10_10_10_2
 	};
 
 	template<> auto EnumNames<ShaderElementType> = SetEnumNames
@@ -48,7 +57,14 @@ namespace Pargon
 		"Matrix4x4",
 		"Color",
 		"Texture",
-		"Sampler"
+		"Sampler",
+		"Half2",
+		"Half4",
+		"SignedNormal2x16",
+		"SignedNormal4x16",
+		"UnsignedNormal2x16",
+		"UnsignedNormal4x16",
+		"UnsignedNormal10_10_10_2"
 	);
 
 	enum class ShaderElementUsage
@@ -67,12 +83,15 @@ namespace Pargon
 		"Other"
 	);
 
+	constexpr int MaximumVertexStreams = 4;
+
 	struct ShaderElement
 	{
 		ShaderElementType Type;
 		ShaderElementUsage Usage;
+		int Stream = 0;
 
-		auto Size() const -> size_t;
+		constexpr auto Size() const -> size_t;
 	};
 
 	void ToString(ShaderElement element, StringWriter& writer);
@@ -252,14 +271,21 @@ namespace Pargon
 		StencilOptions StencilOptions = DisabledStenciling;
 		List<SampleOptions> SampleOptions;
 
-		List<ShaderElement> VertexLayout;
-		List<ShaderElement> InstanceLayout;
 		List<MaterialOutput> Output;
 
 		auto Identifier() const -> StringView;
+		auto VertexLayout() const -> SequenceView<ShaderElement>;
+		auto InstanceLayout() const -> SequenceView<ShaderElement>;
 		auto GetVertexSize() const -> std::size_t;
+		auto GetVertexSize(int stream) const -> std::size_t;
 		auto GetInstanceSize() const -> std::size_t;
 
+		void SetVertexLayout(SequenceView<ShaderElement> layout);
+		void SetInstanceLayout(SequenceView<ShaderElement> layout);
+		template<typename FormatType> void SetVertexFormat();
+		template<typename FormatType> void SetVertexFormat(int stream);
+		template<typename FormatType> void SetInstanceFormat();
+
 		void Reset();
 		auto Reset(StringView filename) -> ShaderCompilationResult;
 		auto Reset(StringView identifier, StringView shaderText) -> ShaderCompilationResult;
@@ -272,11 +298,98 @@ namespace Pargon
 		using GraphicsResource<Material>::GraphicsResource;
 
 		String _identifier;
+		List<ShaderElement> _vertexLayout;
+		List<ShaderElement> _instanceLayout;
+		std::size_t _vertexSize = 0;
+		std::size_t _instanceSize = 0;
 	};
 }
 
+constexpr
+auto Pargon::ShaderElement::Size() const -> size_t
+{
+	switch (Type)
+	{
+	case ShaderElementType::Color: return sizeof(char) * 4;
+	case ShaderElementType::Float: return sizeof(float);
+	case ShaderElementType::Int: return sizeof(int);
+	case ShaderElementType::Matrix3x3: return sizeof(float) * 9;
+	case ShaderElementType::Matrix4x4: return sizeof(float) * 16;
+	case ShaderElementType::Point2: return sizeof(int) * 2;
+	case ShaderElementType::Point3: return sizeof(int) * 3;
+	case ShaderElementType::Point4: return sizeof(int) * 4;
+	case ShaderElementType::Vector2: return sizeof(float) * 2;
+	case ShaderElementType::Vector3: return sizeof(float) * 3;
+	case ShaderElementType::Vector4: return sizeof(float) * 4;
+	case ShaderElementType::Half2: return sizeof(std::uint16_t) * 2;
+	case ShaderElementType::Half4: return sizeof(std::uint16_t) * 4;
+	case ShaderElementType::SignedNormal2x16: return sizeof(std::int16_t) * 2;
+	case ShaderElementType::SignedNormal4x16: return sizeof(std::int16_t) * 4;
+	case ShaderElementType::UnsignedNormal2x16: return sizeof(std::uint16_t) * 2;
+	case ShaderElementType::UnsignedNormal4x16: return sizeof(std::uint16_t) * 4;
+	case ShaderElementType::UnsignedNormal10_10_10_2: return sizeof(std::uint32_t);
+	}
+
+	return 0;
+}
+
 inline
 auto Pargon::Material::Identifier() const -> StringView
 {
 	return _identifier;
 }
+
+inline
+auto Pargon::Material::VertexLayout() const -> SequenceView<ShaderElement>
+{
+	return _vertexLayout;
+}
+
+inline
+auto Pargon::Material::InstanceLayout() const -> SequenceView<ShaderElement>
+{
+	return _instanceLayout;
+}
+
+template<typename FormatType>
+void Pargon::Material::SetVertexFormat()
+{
+	_vertexLayout.Clear();
+
+	for (auto& element : FormatType::Elements)
+		_vertexLayout.Add(element);
+
+	_vertexSize = FormatType::Size;
+}
+
+template<typename FormatType>
+void Pargon::Material::SetVertexFormat(int stream)
+{
+	assert(stream >= 0 && stream < MaximumVertexStreams);
+
+	for (auto i = _vertexLayout.Count() - 1; i >= 0; i--)
+	{
+		if (_vertexLayout.Item(i).Stream == stream)
+			_vertexLayout.RemoveAt(i);
+	}
+
+	for (auto element : FormatType::Elements)
+	{
+		element.Stream = stream;
+		_vertexLayout.Add(element);
+	}
+
+	if (stream == 0)
+		_vertexSize = FormatType::Size;
+}
+
+template<typename FormatType>
+void Pargon::Material::SetInstanceFormat()
+{
+	_instanceLayout.Clear();
+
+	for (auto& element : FormatType::Elements)
+		_instanceLayout.Add(element);
+
+	_instanceSize = FormatType::Size;
+}
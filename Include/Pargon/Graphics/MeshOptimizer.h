@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Pargon/Containers/Buffer.h"
+#include "Pargon/Containers/List.h"
+#include "Pargon/Graphics/Geometry.h"
+
+namespace Pargon
+{
+	struct MeshOptimizationResult
+	{
+		int VertexCount;
+		int IndexCount;
+		std::size_t IndexSize;
+		float CacheMissRatio;
+	};
+
+	class MeshOptimizer
+	{
+	public:
+		static constexpr int DefaultCacheSize = 16;
+		static constexpr int MaximumCacheSize = 32;
+		static constexpr float DefaultOverdrawThreshold = 1.05f;
+		static constexpr int NoPosition = -1;
+
+		auto CacheSize() const -> int;
+		auto OverdrawThreshold() const -> float;
+
+		void SetCacheSize(int size);
+		void SetOverdrawThreshold(float threshold);
+
+		auto Optimize(Geometry& vertices, Geometry& indices, std::size_t vertexSize, std::size_t indexSize, int positionOffset) -> MeshOptimizationResult;
+
+	private:
+		struct Cluster
+		{
+			int Start;
+			int Count;
+			float Sort;
+		};
+
+		int _cacheSize = DefaultCacheSize;
+		float _overdrawThreshold = DefaultOverdrawThreshold;
+
+		Buffer _vertices;
+		Buffer _vertexScratch;
+		List<unsigned int> _indices;
+		List<unsigned int> _indexScratch;
+		List<unsigned int> _remap;
+		List<int> _table;
+
+		List<int> _valence;
+		List<int> _adjacencyOffsets;
+		List<int> _adjacency;
+		List<int> _cachePositions;
+		List<float> _vertexScores;
+		List<std::uint8_t> _emitted;
+		List<unsigned int> _cache;
+		List<unsigned int> _nextCache;
+		List<unsigned int> _timestamps;
+		List<Cluster> _clusters;
+
+		void Load(const Geometry& vertices, const Geometry& indices, std::size_t vertexSize, std::size_t indexSize);
+		void Store(Geometry& vertices, Geometry& indices, std::size_t vertexSize, std::size_t indexSize);
+
+		void WeldVertices(std::size_t vertexSize);
+		void OptimizeVertexCache(int vertexCount);
+		void OptimizeOverdraw(std::size_t vertexSize, int positionOffset);
+		void OptimizeVertexFetch(std::size_t vertexSize);
+
+		auto GetVertexScore(int vertex) const -> float;
+		auto SimulateCache(int vertexCount) -> int;
+	};
+}
+
+inline
+auto Pargon::MeshOptimizer::CacheSize() const -> int
+{
+	return _cacheSize;
+}
+
+inline
+auto Pargon::MeshOptimizer::OverdrawThreshold() const -> float
+{
+	return _overdrawThreshold;
+}
\ No newline at end of file
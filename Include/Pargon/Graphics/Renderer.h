@@ -21,6 +21,125 @@ namespace Pargon
 		void WriteCapabilities(Log& log);
 	};
 
+	enum class RenderPacketType
+	{
+		SetRenderTarget,
+		ClearColorTarget,
+		SetDepthStencilTarget,
+		ClearDepthAndStencilTarget,
+		SetClippingRectangle,
+		SetMaterial,
+		SetTexture,
+		SetVertexBuffer,
+		SetVertexStream,
+		SetInstanceBuffer,
+		SetIndexBuffer,
+		SetConstantBuffer,
+		DrawVertices,
+		DrawIndices,
+		DrawInstances,
+		DrawIndexedInstances,
+		MultiDraw
+	};
+
+	struct RenderPacket
+	{
+		struct SetTarget
+		{
+			Texture* Texture;
+			TextureHandle* Handle;
+			int Slot;
+		};
+
+		struct ClearColorTarget
+		{
+			float R;
+			float G;
+			float B;
+			float A;
+		};
+
+		struct ClearDepthAndStencilTarget
+		{
+			float Depth;
+			int Stencil;
+		};
+
+		struct SetClippingRectangle
+		{
+			float X;
+			float Y;
+			float Width;
+			float Height;
+		};
+
+		struct SetMaterial
+		{
+			Material* Material;
+			MaterialHandle* Handle;
+		};
+
+		struct SetBuffer
+		{
+			Geometry* Geometry;
+			GeometryHandle* Handle;
+			std::size_t ElementSize;
+		};
+
+		struct SetStream
+		{
+			Geometry* Geometry;
+			GeometryHandle* Handle;
+			std::size_t ElementSize;
+			int Stream;
+		};
+
+		struct SetConstantBuffer
+		{
+			Geometry* Geometry;
+			GeometryHandle* Handle;
+			int Offset;
+			std::size_t Size;
+			int Slot;
+			bool VertexAccess;
+			bool FragmentAccess;
+		};
+
+		struct Draw
+		{
+			int First;
+			int Count;
+			int FirstInstance;
+			int InstanceCount;
+		};
+
+		struct MultiDraw
+		{
+			const DrawRange* Ranges;
+			int Count;
+			bool Indexed;
+		};
+
+		union Data
+		{
+			Data() {}
+
+			SetTarget SetTarget;
+			ClearColorTarget ClearColorTarget;
+			ClearDepthAndStencilTarget ClearDepthAndStencilTarget;
+			SetClippingRectangle SetClippingRectangle;
+			SetMaterial SetMaterial;
+			SetBuffer SetBuffer;
+			SetStream SetStream;
+			SetConstantBuffer SetConstantBuffer;
+			Draw Draw;
+			MultiDraw MultiDraw;
+		};
+
+		RenderPacketType Type;
+		Data Data;
+	};
+
 	class Renderer
 	{
 	public:
@@ -41,6 +160,7 @@ namespace Pargon
 		virtual auto CreateTextureHandle() -> std::unique_ptr<TextureHandle> = 0;
 
 		virtual void BeginFrame() = 0;
+		virtual void Execute(SequenceView<RenderPacket> packets);
 		virtual void SetRenderTarget(Texture* texture, int slot) = 0;
 		virtual void ClearColorTarget(float r, float g, float b, float a) = 0;
 		virtual void SetDepthStencilTarget(Texture* texture) = 0;
@@ -49,6 +169,7 @@ namespace Pargon
 		virtual void SetMaterial(Material* material) = 0;
 		virtual void SetTexture(Texture* texture, int slot) = 0;
 		virtual void SetVertexBuffer(Geometry* geometry, std::size_t vertexSize) = 0;
+		virtual void SetVertexStream(Geometry* geometry, std::size_t vertexSize, int stream) = 0;
 		virtual void SetInstanceBuffer(Geometry* geometry, std::size_t vertexSize) = 0;
 		virtual void SetIndexBuffer(Geometry* geometry, std::size_t indexSize) = 0;
 		virtual void SetConstantBuffer(Geometry* geometry, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot) = 0;
@@ -56,6 +177,7 @@ namespace Pargon
 		virtual void DrawIndices(int firstIndex, int indexCount) = 0;
 		virtual void DrawInstances(int firstVertex, int vertexCount, int firstInstance, int instanceCount) = 0;
 		virtual void DrawIndexedInstances(int firstIndex, int indexCount, int firstInstance, int instanceCount) = 0;
+		virtual void MultiDraw(SequenceView<DrawRange> ranges, bool indexed) = 0;
 		virtual void EndFrame(int synchronization) = 0;
 	};
 }
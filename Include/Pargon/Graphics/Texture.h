@@ -240,6 +240,10 @@ namespace Pargon
 
 	protected:
 		void Clear() override;
+		auto HashContents() const -> std::uint64_t override;
+		auto ContentSize() const -> std::size_t override;
+		auto CreateSnapshot() const -> std::unique_ptr<GraphicsResource_> override;
+		void CopyContents(GraphicsResource_& snapshot, bool pending) const override;
 
 	private:
 		friend class GraphicsDevice;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Pargon/Graphics/Geometry.h"
+#include "Pargon/Graphics/Material.h"
+#include "Pargon/Graphics/VertexPacking.h"
+#include "Pargon/Math/Vector.h"
+
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+namespace Pargon
+{
+	template<ShaderElementType ElementType, typename ComponentType, int ComponentCount>
+	struct PackedShaderElement
+	{
+		ComponentType Components[ComponentCount];
+	};
+
+	using HalfVector2 = PackedShaderElement<ShaderElementType::Half2, std::uint16_t, 2>;
+	using HalfVector4 = PackedShaderElement<ShaderElementType::Half4, std::uint16_t, 4>;
+	using SignedNormalVector2 = PackedShaderElement<ShaderElementType::SignedNormal2x16, std::int16_t, 2>;
+	using SignedNormalVector4 = PackedShaderElement<ShaderElementType::SignedNormal4x16, std::int16_t, 4>;
+	using UnsignedNormalVector2 = PackedShaderElement<ShaderElementType::UnsignedNormal2x16, std::uint16_t, 2>;
+	using UnsignedNormalVector4 = PackedShaderElement<ShaderElementType::UnsignedNormal4x16, std::uint16_t, 4>;
+	using PackedNormal = PackedShaderElement<ShaderElementType::UnsignedNormal10_10_10_2, std::uint32_t, 1>;
+	using PackedColor = PackedShaderElement<ShaderElementType::Color, std::uint8_t, 4>;
+
+	template<typename AttributeType> struct ShaderElementTraits;
+
+	template<> struct ShaderElementTraits<float> { static constexpr auto Type = ShaderElementType::Float; };
+	template<> struct ShaderElementTraits<int> { static constexpr auto Type = ShaderElementType::Int; };
+	template<> struct ShaderElementTraits<Vector2> { static constexpr auto Type = ShaderElementType::Vector2; };
+	template<> struct ShaderElementTraits<Vector3> { static constexpr auto Type = ShaderElementType::Vector3; };
+	template<> struct ShaderElementTraits<Vector4> { static constexpr auto Type = ShaderElementType::Vector4; };
+
+	template<ShaderElementType ElementType, typename ComponentType, int ComponentCount>
+	struct ShaderElementTraits<PackedShaderElement<ElementType, ComponentType, ComponentCount>>
+	{
+		static constexpr auto Type = ElementType;
+	};
+
+	template<typename AttributeType, ShaderElementUsage AttributeUsage>
+	struct VertexAttribute
+	{
+		using Type = AttributeType;
+
+		static constexpr auto Element = ShaderElement{ ShaderElementTraits<AttributeType>::Type, AttributeUsage };
+	};
+
+	template<typename VertexType, typename... Attributes>
+	class VertexFormat
+	{
+	public:
+		using Vertex = VertexType;
+		template<int Index> using Attribute = typename std::tuple_element<Index, std::tuple<Attributes...>>::type::Type;
+
+		static constexpr int ElementCount = sizeof...(Attributes);
+		static constexpr std::size_t Size = sizeof(VertexType);
+		static constexpr ShaderElement Elements[] = { Attributes::Element... };
+
+		static constexpr auto Offset(int index) -> std::size_t;
+
+		static void Copy(SequenceView<VertexType> vertices, const GeometryReservation<VertexType>& reservation);
+		template<int Index> static void Copy(SequenceView<Attribute<Index>> attributes, const GeometryReservation<VertexType>& reservation);
+		template<int Index> static void Pack(SequenceView<float> attributes, const GeometryReservation<VertexType>& reservation);
+
+	private:
+		static_assert(ElementCount > 0, "a vertex format must have at least one attribute");
+		static_assert(std::is_trivially_copyable<VertexType>::value && std::is_standard_layout<VertexType>::value, "vertex types must be plain data");
+		static_assert(((sizeof(typename Attributes::Type) == Attributes::Element.Size()) && ...), "vertex attribute types must match the size of their shader element");
+		static_assert(((sizeof(typename Attributes::Type) % 4 == 0 && 4 % alignof(typename Attributes::Type) == 0) && ...), "vertex attributes must keep four byte alignment");
+		static_assert((sizeof(typename Attributes::Type) + ...) == Size, "vertex types must contain exactly their attributes with no padding");
+	};
+}
+
+template<typename VertexType, typename... Attributes>
+constexpr
+auto Pargon::VertexFormat<VertexType, Attributes...>::Offset(int index) -> std::size_t
+{
+	constexpr std::size_t sizes[] = { sizeof(typename Attributes::Type)... };
+
+	auto offset = std::size_t(0);
+
+	for (auto i = 0; i < index; i++)
+		offset += sizes[i];
+
+	return offset;
+}
+
+template<typename VertexType, typename... Attributes>
+void Pargon::VertexFormat<VertexType, Attributes...>::Copy(SequenceView<VertexType> vertices, const GeometryReservation<VertexType>& reservation)
+{
+	assert(reservation.ElementSize == Size && vertices.Count() == reservation.ElementCount);
+
+	if (vertices.Count() > 0)
+		std::memcpy(reservation.Elements.begin(), vertices.begin(), vertices.Count() * Size);
+}
+
+template<typename VertexType, typename... Attributes>
+template<int Index>
+void Pargon::VertexFormat<VertexType, Attributes...>::Copy(SequenceView<Attribute<Index>> attributes, const GeometryReservation<VertexType>& reservation)
+{
+	assert(reservation.ElementSize == Size && attributes.Count() == reservation.ElementCount);
+
+	auto destination = reinterpret_cast<std::uint8_t*>(reservation.Elements.begin()) + Offset(Index);
+
+	for (auto i = 0; i < attributes.Count(); i++)
+		std::memcpy(destination + i * Size, attributes.begin() + i, sizeof(Attribute<Index>));
+}
+
+template<typename VertexType, typename... Attributes>
+template<int Index>
+void Pargon::VertexFormat<VertexType, Attributes...>::Pack(SequenceView<float> attributes, const GeometryReservation<VertexType>& reservation)
+{
+	assert(reservation.ElementSize == Size);
+	PackShaderElements(Elements[Index].Type, attributes, reservation, Offset(Index));
+}
\ No newline at end of file
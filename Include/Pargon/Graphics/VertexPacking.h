@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Pargon/Containers/Buffer.h"
+#include "Pargon/Graphics/Geometry.h"
+#include "Pargon/Graphics/Material.h"
+
+namespace Pargon
+{
+	auto GetComponentCount(ShaderElementType type) -> int;
+
+	void PackShaderElements(ShaderElementType type, SequenceView<float> source, BufferReference destination, std::size_t stride);
+	void PackShaderElements(ShaderElementType type, SequenceView<float> source, const Geometry::Reservation& reservation, std::size_t offset);
+	template<typename ElementType> void PackShaderElements(ShaderElementType type, SequenceView<float> source, const GeometryReservation<ElementType>& reservation, std::size_t offset);
+}
+
+template<typename ElementType>
+void Pargon::PackShaderElements(ShaderElementType type, SequenceView<float> source, const GeometryReservation<ElementType>& reservation, std::size_t offset)
+{
+	assert(source.Count() == reservation.ElementCount * GetComponentCount(type));
+
+	auto data = reinterpret_cast<std::uint8_t*>(reservation.Elements.begin());
+	auto size = static_cast<int>(reservation.ElementCount * reservation.ElementSize - offset);
+
+	PackShaderElements(type, source, { data + offset, size }, reservation.ElementSize);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#include "Pargon/Graphics/CommandBundle.h"
+
+using namespace Pargon;
+
+void CommandBundle::Clear()
+{
+	CommandList::Clear();
+
+	_isValid = true;
+	_validatedRevision = 0;
+	_topologies.Clear();
+}
\ No newline at end of file
@@ -0,0 +1,593 @@
+#include "Pargon/Graphics/CommandList.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using namespace Pargon;
+
+namespace
+{
+	template<typename ValueType>
+	void WriteValue(std::uint8_t*& data, ValueType value)
+	{
+		std::memcpy(data, std::addressof(value), sizeof(ValueType));
+		data += sizeof(ValueType);
+	}
+
+	template<typename ValueType>
+	auto ReadValue(const std::uint8_t*& data) -> ValueType
+	{
+		ValueType value;
+		std::memcpy(std::addressof(value), data, sizeof(ValueType));
+		data += sizeof(ValueType);
+		return value;
+	}
+
+	auto NarrowSlot(int slot) -> std::uint8_t
+	{
+		assert(slot >= 0 && slot <= std::numeric_limits<std::uint8_t>::max());
+		return static_cast<std::uint8_t>(slot);
+	}
+
+	auto NarrowSize(std::size_t size) -> std::uint32_t
+	{
+		assert(size <= std::numeric_limits<std::uint32_t>::max());
+		return static_cast<std::uint32_t>(size);
+	}
+}
+
+void CommandList::SetColorTarget(TextureId texture, int slot)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetColorTarget;
+	command.Data.SetColorTarget.Texture = texture;
+	command.Data.SetColorTarget.Slot = slot;
+
+	Write(command);
+}
+
+void CommandList::ClearColorTarget(float red, float green, float blue, float alpha)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::ClearColorTarget;
+	command.Data.ClearColorTarget.R = red;
+	command.Data.ClearColorTarget.G = green;
+	command.Data.ClearColorTarget.B = blue;
+	command.Data.ClearColorTarget.A = alpha;
+
+	Write(command);
+}
+
+void CommandList::SetDepthStencilTarget(TextureId texture)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetDepthStencilTarget;
+	command.Data.SetDepthStencilTarget.Texture = texture;
+
+	Write(command);
+}
+
+void CommandList::ClearDepthStencilTarget(float depthValue, int stencilValue)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::ClearDepthStencilTarget;
+	command.Data.ClearDepthStencilTarget.DepthValue = depthValue;
+	command.Data.ClearDepthStencilTarget.StencilValue = stencilValue;
+
+	Write(command);
+}
+
+void CommandList::SetClippingRectangle(float x, float y, float width, float height)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetClippingRectangle;
+	command.Data.SetClippingRectangle.X = x;
+	command.Data.SetClippingRectangle.Y = y;
+	command.Data.SetClippingRectangle.Width = width;
+	command.Data.SetClippingRectangle.Height = height;
+
+	Write(command);
+}
+
+void CommandList::SetMaterial(MaterialId material)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetMaterial;
+	command.Data.SetMaterial.Material = material;
+
+	Write(command);
+}
+
+void CommandList::SetTexture(TextureId texture, int slot)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetTexture;
+	command.Data.SetTexture.Texture = texture;
+	command.Data.SetTexture.Slot = slot;
+
+	Write(command);
+}
+
+void CommandList::SetVertexBuffer(GeometryId geometry, std::size_t vertexSize)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetVertexBuffer;
+	command.Data.SetVertexBuffer.Geometry = geometry;
+	command.Data.SetVertexBuffer.VertexSize = vertexSize;
+
+	Write(command);
+}
+
+void CommandList::SetVertexStream(GeometryId geometry, std::size_t vertexSize, int stream)
+{
+	assert(stream > 0 && stream < MaximumVertexStreams);
+
+	RenderCommand command;
+	command.Type = RenderCommandType::SetVertexStream;
+	command.Data.SetVertexStream.Geometry = geometry;
+	command.Data.SetVertexStream.VertexSize = vertexSize;
+	command.Data.SetVertexStream.Stream = stream;
+
+	Write(command);
+}
+
+void CommandList::SetInstanceBuffer(GeometryId geometry, std::size_t instanceSize)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetInstanceBuffer;
+	command.Data.SetInstanceBuffer.Geometry = geometry;
+	command.Data.SetInstanceBuffer.InstanceSize = instanceSize;
+
+	Write(command);
+}
+
+void CommandList::SetIndexBuffer(GeometryId geometry, std::size_t indexSize)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetIndexBuffer;
+	command.Data.SetIndexBuffer.Geometry = geometry;
+	command.Data.SetIndexBuffer.IndexSize = indexSize;
+
+	Write(command);
+}
+
+void CommandList::SetConstantBuffer(GeometryId geometry, bool vertexAccess, bool fragmentAccess, int start, std::size_t size, int slot)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetConstantBuffer;
+	command.Data.SetConstantBuffer.Geometry = geometry;
+	command.Data.SetConstantBuffer.Start = start;
+	command.Data.SetConstantBuffer.Size = size;
+	command.Data.SetConstantBuffer.Slot = slot;
+	command.Data.SetConstantBuffer.VertexAccess = vertexAccess;
+	command.Data.SetConstantBuffer.FragmentAccess = fragmentAccess;
+
+	Write(command);
+}
+
+void CommandList::Draw(int start, int count)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::Draw;
+	command.Data.Draw.Start = start;
+	command.Data.Draw.Count = count;
+
+	Write(command);
+}
+
+void CommandList::MultiDraw(SequenceView<DrawRange> ranges)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::MultiDraw;
+	command.Data.MultiDraw.Count = ranges.Count();
+	command.Data.MultiDraw.Ranges = reinterpret_cast<const std::uint8_t*>(ranges.begin());
+
+	Write(command);
+}
+
+void CommandList::SetLayer(int layer)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::SetLayer;
+	command.Data.SetLayer.Layer = layer;
+
+	Write(command);
+}
+
+void CommandList::Replay(const CommandBundle& bundle)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::ExecuteCommandBundle;
+	command.Data.ExecuteCommandBundle.Bundle = std::addressof(bundle);
+
+	Write(command);
+}
+
+void CommandList::Clear()
+{
+	_size = 0;
+	_count = 0;
+}
+
+void CommandList::ExecuteCommandList(const CommandList& commands)
+{
+	RenderCommand command;
+	command.Type = RenderCommandType::ExecuteCommandList;
+	command.Data.ExecuteCommandList.Commands = std::addressof(commands);
+
+	Write(command);
+}
+
+auto CommandList::GetFixedSize(RenderCommandType type) -> int
+{
+	constexpr auto id = static_cast<int>(sizeof(std::int32_t));
+	constexpr auto value = static_cast<int>(sizeof(std::int32_t));
+	constexpr auto slot = static_cast<int>(sizeof(std::uint8_t));
+
+	switch (type)
+	{
+	case RenderCommandType::SetColorTarget: return 1 + id + slot;
+	case RenderCommandType::SetDepthStencilTarget: return 1 + id;
+	case RenderCommandType::ClearColorTarget: return 1 + 4 * value;
+	case RenderCommandType::ClearDepthStencilTarget: return 1 + 2 * value;
+	case RenderCommandType::SetClippingRectangle: return 1 + 4 * value;
+	case RenderCommandType::SetMaterial: return 1 + id;
+	case RenderCommandType::SetTexture: return 1 + id + slot;
+	case RenderCommandType::SetVertexBuffer: return 1 + id + value;
+	case RenderCommandType::SetVertexStream: return 1 + id + value + slot;
+	case RenderCommandType::SetInstanceBuffer: return 1 + id + value;
+	case RenderCommandType::SetIndexBuffer: return 1 + id + value;
+	case RenderCommandType::SetConstantBuffer: return 1 + id + 2 * value + 2 * slot;
+	case RenderCommandType::Draw: return 1 + 2 * value;
+	case RenderCommandType::MultiDraw: return 1 + value;
+	case RenderCommandType::SetLayer: return 1 + value;
+	case RenderCommandType::ExecuteCommandList: return 1 + static_cast<int>(sizeof(const CommandList*));
+	case RenderCommandType::ExecuteCommandBundle: return 1 + static_cast<int>(sizeof(const CommandBundle*));
+	}
+
+	return 1;
+}
+
+auto CommandList::GetEncodedSize(const RenderCommand& command) -> int
+{
+	auto size = GetFixedSize(command.Type);
+
+	if (command.Type == RenderCommandType::MultiDraw)
+		size += command.Data.MultiDraw.Count * static_cast<int>(sizeof(DrawRange));
+
+	return size;
+}
+
+auto CommandList::GetEncodedSize(EncodedCommand command) -> int
+{
+	auto type = GetType(command);
+	auto size = GetFixedSize(type);
+
+	if (type == RenderCommandType::MultiDraw)
+	{
+		auto data = command + 1;
+		size += ReadValue<std::int32_t>(data) * static_cast<int>(sizeof(DrawRange));
+	}
+
+	return size;
+}
+
+auto CommandList::GetDrawRange(const RenderCommand::MultiDraw& command, int index) -> DrawRange
+{
+	assert(index >= 0 && index < command.Count);
+
+	auto data = command.Ranges + index * sizeof(DrawRange);
+	return ReadValue<DrawRange>(data);
+}
+
+auto CommandList::Read(EncodedCommand command) -> RenderCommand
+{
+	RenderCommand decoded;
+	decoded.Type = GetType(command);
+
+	auto data = command + 1;
+	auto& result = decoded.Data;
+
+	switch (decoded.Type)
+	{
+	case RenderCommandType::SetColorTarget:
+	{
+		result.SetColorTarget.Texture = TextureId(ReadValue<std::int32_t>(data));
+		result.SetColorTarget.Slot = ReadValue<std::uint8_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetDepthStencilTarget:
+	{
+		result.SetDepthStencilTarget.Texture = TextureId(ReadValue<std::int32_t>(data));
+		break;
+	}
+
+	case RenderCommandType::ClearColorTarget:
+	{
+		result.ClearColorTarget.R = ReadValue<float>(data);
+		result.ClearColorTarget.G = ReadValue<float>(data);
+		result.ClearColorTarget.B = ReadValue<float>(data);
+		result.ClearColorTarget.A = ReadValue<float>(data);
+		break;
+	}
+
+	case RenderCommandType::ClearDepthStencilTarget:
+	{
+		result.ClearDepthStencilTarget.DepthValue = ReadValue<float>(data);
+		result.ClearDepthStencilTarget.StencilValue = ReadValue<std::int32_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetClippingRectangle:
+	{
+		result.SetClippingRectangle.X = ReadValue<float>(data);
+		result.SetClippingRectangle.Y = ReadValue<float>(data);
+		result.SetClippingRectangle.Width = ReadValue<float>(data);
+		result.SetClippingRectangle.Height = ReadValue<float>(data);
+		break;
+	}
+
+	case RenderCommandType::SetMaterial:
+	{
+		result.SetMaterial.Material = MaterialId(ReadValue<std::int32_t>(data));
+		break;
+	}
+
+	case RenderCommandType::SetTexture:
+	{
+		result.SetTexture.Texture = TextureId(ReadValue<std::int32_t>(data));
+		result.SetTexture.Slot = ReadValue<std::uint8_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetVertexBuffer:
+	{
+		result.SetVertexBuffer.Geometry = GeometryId(ReadValue<std::int32_t>(data));
+		result.SetVertexBuffer.VertexSize = ReadValue<std::uint32_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetVertexStream:
+	{
+		result.SetVertexStream.Geometry = GeometryId(ReadValue<std::int32_t>(data));
+		result.SetVertexStream.VertexSize = ReadValue<std::uint32_t>(data);
+		result.SetVertexStream.Stream = ReadValue<std::uint8_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetInstanceBuffer:
+	{
+		result.SetInstanceBuffer.Geometry = GeometryId(ReadValue<std::int32_t>(data));
+		result.SetInstanceBuffer.InstanceSize = ReadValue<std::uint32_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetIndexBuffer:
+	{
+		result.SetIndexBuffer.Geometry = GeometryId(ReadValue<std::int32_t>(data));
+		result.SetIndexBuffer.IndexSize = ReadValue<std::uint32_t>(data);
+		break;
+	}
+
+	case RenderCommandType::SetConstantBuffer:
+	{
+		result.SetConstantBuffer.Geometry = GeometryId(ReadValue<std::int32_t>(data));
+		result.SetConstantBuffer.Start = ReadValue<std::int32_t>(data);
+		result.SetConstantBuffer.Size = ReadValue<std::uint32_t>(data);
+		result.SetConstantBuffer.Slot = ReadValue<std::uint8_t>(data);
+
+		auto access = ReadValue<std::uint8_t>(data);
+		result.SetConstantBuffer.VertexAccess = (access & 0x1) != 0;
+		result.SetConstantBuffer.FragmentAccess = (access & 0x2) != 0;
+		break;
+	}
+
+	case RenderCommandType::Draw:
+	{
+		result.Draw.Start = ReadValue<std::int32_t>(data);
+		result.Draw.Count = ReadValue<std::int32_t>(data);
+		break;
+	}
+
+	case RenderCommandType::MultiDraw:
+	{
+		result.MultiDraw.Count = ReadValue<std::int32_t>(data);
+		result.MultiDraw.Ranges = data;
+		break;
+	}
+
+	case RenderCommandType::SetLayer:
+	{
+		result.SetLayer.Layer = ReadValue<std::int32_t>(data);
+		break;
+	}
+
+	case RenderCommandType::ExecuteCommandList:
+	{
+		result.ExecuteCommandList.Commands = ReadValue<const CommandList*>(data);
+		break;
+	}
+
+	case RenderCommandType::ExecuteCommandBundle:
+	{
+		result.ExecuteCommandBundle.Bundle = ReadValue<const CommandBundle*>(data);
+		break;
+	}
+	}
+
+	return decoded;
+}
+
+auto CommandList::IsSame(EncodedCommand left, EncodedCommand right) -> bool
+{
+	auto size = GetEncodedSize(left);
+	return size == GetEncodedSize(right) && std::memcmp(left, right, size) == 0;
+}
+
+void CommandList::Encode(const RenderCommand& command, std::uint8_t* data)
+{
+	auto& source = command.Data;
+
+	WriteValue(data, static_cast<std::uint8_t>(command.Type));
+
+	switch (command.Type)
+	{
+	case RenderCommandType::SetColorTarget:
+	{
+		WriteValue<std::int32_t>(data, source.SetColorTarget.Texture._id);
+		WriteValue(data, NarrowSlot(source.SetColorTarget.Slot));
+		break;
+	}
+
+	case RenderCommandType::SetDepthStencilTarget:
+	{
+		WriteValue<std::int32_t>(data, source.SetDepthStencilTarget.Texture._id);
+		break;
+	}
+
+	case RenderCommandType::ClearColorTarget:
+	{
+		WriteValue(data, source.ClearColorTarget.R);
+		WriteValue(data, source.ClearColorTarget.G);
+		WriteValue(data, source.ClearColorTarget.B);
+		WriteValue(data, source.ClearColorTarget.A);
+		break;
+	}
+
+	case RenderCommandType::ClearDepthStencilTarget:
+	{
+		WriteValue(data, source.ClearDepthStencilTarget.DepthValue);
+		WriteValue<std::int32_t>(data, source.ClearDepthStencilTarget.StencilValue);
+		break;
+	}
+
+	case RenderCommandType::SetClippingRectangle:
+	{
+		WriteValue(data, source.SetClippingRectangle.X);
+		WriteValue(data, source.SetClippingRectangle.Y);
+		WriteValue(data, source.SetClippingRectangle.Width);
+		WriteValue(data, source.SetClippingRectangle.Height);
+		break;
+	}
+
+	case RenderCommandType::SetMaterial:
+	{
+		WriteValue<std::int32_t>(data, source.SetMaterial.Material._id);
+		break;
+	}
+
+	case RenderCommandType::SetTexture:
+	{
+		WriteValue<std::int32_t>(data, source.SetTexture.Texture._id);
+		WriteValue(data, NarrowSlot(source.SetTexture.Slot));
+		break;
+	}
+
+	case RenderCommandType::SetVertexBuffer:
+	{
+		WriteValue<std::int32_t>(data, source.SetVertexBuffer.Geometry._id);
+		WriteValue(data, NarrowSize(source.SetVertexBuffer.VertexSize));
+		break;
+	}
+
+	case RenderCommandType::SetVertexStream:
+	{
+		WriteValue<std::int32_t>(data, source.SetVertexStream.Geometry._id);
+		WriteValue(data, NarrowSize(source.SetVertexStream.VertexSize));
+		WriteValue(data, NarrowSlot(source.SetVertexStream.Stream));
+		break;
+	}
+
+	case RenderCommandType::SetInstanceBuffer:
+	{
+		WriteValue<std::int32_t>(data, source.SetInstanceBuffer.Geometry._id);
+		WriteValue(data, NarrowSize(source.SetInstanceBuffer.InstanceSize));
+		break;
+	}
+
+	case RenderCommandType::SetIndexBuffer:
+	{
+		WriteValue<std::int32_t>(data, source.SetIndexBuffer.Geometry._id);
+		WriteValue(data, NarrowSize(source.SetIndexBuffer.IndexSize));
+		break;
+	}
+
+	case RenderCommandType::SetConstantBuffer:
+	{
+		auto access = (source.SetConstantBuffer.VertexAccess ? 0x1 : 0x0) | (source.SetConstantBuffer.FragmentAccess ? 0x2 : 0x0);
+
+		WriteValue<std::int32_t>(data, source.SetConstantBuffer.Geometry._id);
+		WriteValue<std::int32_t>(data, source.SetConstantBuffer.Start);
+		WriteValue(data, NarrowSize(source.SetConstantBuffer.Size));
+		WriteValue(data, NarrowSlot(source.SetConstantBuffer.Slot));
+		WriteValue(data, static_cast<std::uint8_t>(access));
+		break;
+	}
+
+	case RenderCommandType::Draw:
+	{
+		WriteValue<std::int32_t>(data, source.Draw.Start);
+		WriteValue<std::int32_t>(data, source.Draw.Count);
+		break;
+	}
+
+	case RenderCommandType::MultiDraw:
+	{
+		WriteValue<std::int32_t>(data, source.MultiDraw.Count);
+		std::memcpy(data, source.MultiDraw.Ranges, source.MultiDraw.Count * sizeof(DrawRange));
+		break;
+	}
+
+	case RenderCommandType::SetLayer:
+	{
+		WriteValue<std::int32_t>(data, source.SetLayer.Layer);
+		break;
+	}
+
+	case RenderCommandType::ExecuteCommandList:
+	{
+		WriteValue(data, source.ExecuteCommandList.Commands);
+		break;
+	}
+
+	case RenderCommandType::ExecuteCommandBundle:
+	{
+		WriteValue(data, source.ExecuteCommandBundle.Bundle);
+		break;
+	}
+	}
+}
+
+void CommandList::Write(const RenderCommand& command)
+{
+	auto size = GetEncodedSize(command);
+
+	if (_size + size > _stream.Size())
+		_stream.SetSize(std::max(_size + size, _stream.Size() * 2));
+
+	Encode(command, _stream.begin() + _size);
+
+	_size += size;
+	_count++;
+}
+
+void CommandList::Append(EncodedCommand command)
+{
+	auto size = GetEncodedSize(command);
+
+	if (_size + size > _stream.Size())
+		_stream.SetSize(std::max(_size + size, _stream.Size() * 2));
+
+	std::memcpy(_stream.begin() + _size, command, size);
+
+	_size += size;
+	_count++;
+}
+
+void CommandList::Overwrite(int offset, const RenderCommand& command)
+{
+	assert(GetType(Begin() + offset) == command.Type);
+	Encode(command, _stream.begin() + offset);
+}
\ No newline at end of file
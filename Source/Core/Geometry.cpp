@@ -3,15 +3,41 @@
 #include "Pargon/Serialization/StringReader.h"
 #include "Pargon/Serialization/StringWriter.h"
 
+#include <algorithm>
+
 using namespace Pargon;
 
 void Geometry::Reset(GeometryTopology topology, int capacity)
 {
 	assert(IsLocked());
 
+	if (topology != _topology)
+		InvalidateCommandBundles();
+
 	_topology = topology;
-	_data.SetSize(capacity);
+	_mapped = Storage() == GraphicsStorage::MappedToGpu ? Handle<GeometryHandle>()->Map(this, capacity) : BufferReference();
+	_data.SetSize(IsMapped() ? 0 : capacity);
+	_adopted = {};
 	_size = 0;
+	_isFullyChanged = true;
+	_changedRanges.Clear();
+}
+
+void Geometry::Adopt(GeometryTopology topology, BufferView data)
+{
+	assert(IsLocked());
+	assert(Storage() != GraphicsStorage::MappedToGpu && Storage() != GraphicsStorage::FrameTransient);
+	assert(topology != GeometryTopology::ConstantData || (data.Size() % _constantDataOffset == 0));
+
+	if (topology != _topology)
+		InvalidateCommandBundles();
+
+	_topology = topology;
+	_data.SetSize(0);
+	_adopted = data;
+	_size = static_cast<std::size_t>(data.Size());
+	_isFullyChanged = true;
+	_changedRanges.Clear();
 }
 
 namespace
@@ -43,11 +69,45 @@ auto Geometry::Reserve(std::size_t size, int count) -> Reservation
 	auto required = count * size + alignment;
 	auto location = static_cast<int>(_size + alignment);
 
-	_data.SetSize(static_cast<int>(_size + required));
+	if (IsAdopted() || (IsMapped() && _size + required > static_cast<std::size_t>(_mapped.Size())))
+		Detach();
+
+	if (!IsMapped())
+		_data.SetSize(static_cast<int>(_size + required));
 
 	_size += required;
 
-	return { offset, count, size, _data.GetReference(location, static_cast<int>(count * size)) };
+	MarkChanged(location, count * size);
+	return { offset, count, size, GetReference(location, static_cast<int>(count * size)) };
+}
+
+auto Geometry::ReserveParallel(std::size_t size, int count) -> Reservation
+{
+	ValidateReservation(size, count);
+
+	assert(!IsAdopted());
+
+	_isFullyChanged.store(true, std::memory_order_relaxed);
+
+	auto capacity = static_cast<std::size_t>(IsMapped() ? _mapped.Size() : _data.Size());
+	auto location = _size.load(std::memory_order_relaxed);
+	auto alignment = std::size_t(0);
+	auto required = std::size_t(0);
+
+	do
+	{
+		alignment = GetAlignment(location, _topology == GeometryTopology::ConstantData ? _constantDataAlignment : size);
+		required = count * size + alignment;
+
+		assert(location + required <= capacity);
+
+		if (location + required > capacity)
+			return { 0, 0, size, {} };
+	}
+	while (!_size.compare_exchange_weak(location, location + required, std::memory_order_relaxed));
+
+	auto offset = GetOffset(location, alignment, _topology == GeometryTopology::ConstantData ? _constantDataOffset : size);
+	return { offset, count, size, GetReference(static_cast<int>(location + alignment), static_cast<int>(count * size)) };
 }
 
 auto Geometry::Retreive(std::size_t size, int start, int count) -> Reservation
@@ -58,12 +118,63 @@ auto Geometry::Retreive(std::size_t size, int start, int count) -> Reservation
 	auto offset = GetOffset((start * size), alignment, _topology == GeometryTopology::ConstantData ? _constantDataOffset : size);
 	auto location = static_cast<int>((start * size) + alignment);
 
-	return { offset, count, size, _data.GetReference(location, static_cast<int>(count * size)) };
+	if (IsAdopted())
+		Detach();
+
+	MarkChanged(location, count * size);
+	return { offset, count, size, GetReference(location, static_cast<int>(count * size)) };
 }
 
 void Geometry::Clear()
 {
 	_data.Clear();
+	_mapped = {};
+	_adopted = {};
+}
+
+void Geometry::ClearChanges()
+{
+	_isFullyChanged = false;
+	_changedRanges.Clear();
+	_adopted = {};
+}
+
+auto Geometry::HashContents() const -> std::uint64_t
+{
+	if (IsMapped())
+		return 0;
+
+	return HashBytes(Data(), (static_cast<std::uint64_t>(_topology) << 56) ^ _size);
+}
+
+auto Geometry::ContentSize() const -> std::size_t
+{
+	return _size;
+}
+
+auto Geometry::CreateSnapshot() const -> std::unique_ptr<GraphicsResource_>
+{
+	return std::unique_ptr<Geometry>(new Geometry(Graphics(), Storage(), nullptr, Id()));
+}
+
+void Geometry::CopyContents(GraphicsResource_& snapshot, bool pending) const
+{
+	auto& geometry = static_cast<Geometry&>(snapshot);
+
+	geometry._topology = _topology;
+	geometry._data.SetSize(static_cast<int>(_size));
+	geometry._size = Size();
+	geometry._isFullyChanged = _isFullyChanged || pending;
+	geometry._changedRanges.Clear();
+
+	auto contents = Data();
+	std::copy(contents.begin(), contents.end(), geometry._data.begin());
+
+	if (!geometry._isFullyChanged)
+	{
+		for (auto& range : _changedRanges)
+			geometry._changedRanges.Add(range);
+	}
 }
 
 void Geometry::ValidateReservation(std::size_t size, int count)
@@ -73,3 +184,63 @@ void Geometry::ValidateReservation(std::size_t size, int count)
 	assert(_topology != GeometryTopology::ConstantData || (size % _constantDataOffset == 0));
 	assert(_topology != GeometryTopology::IndexList || size == 2 || size == 4);
 }
+
+void Geometry::Detach()
+{
+	auto contents = Data();
+
+	_data.SetSize(static_cast<int>(_size));
+	std::copy(contents.begin(), contents.end(), _data.begin());
+	_mapped = {};
+	_adopted = {};
+}
+
+auto Geometry::GetReference(int location, int size) -> BufferReference
+{
+	return IsMapped() ? BufferReference(_mapped.begin() + location, size) : _data.GetReference(location, size);
+}
+
+void Geometry::MarkChanged(std::size_t start, std::size_t size)
+{
+	if (_isFullyChanged || size == 0)
+		return;
+
+	auto end = start + size;
+	auto first = 0;
+
+	while (first < _changedRanges.Count() && _changedRanges.Item(first).Start + _changedRanges.Item(first).Size < start)
+		first++;
+
+	auto last = first;
+
+	while (last < _changedRanges.Count() && _changedRanges.Item(last).Start <= end)
+	{
+		auto& range = _changedRanges.Item(last++);
+		start = std::min(start, range.Start);
+		end = std::max(end, range.Start + range.Size);
+	}
+
+	if (last == first)
+	{
+		_changedRanges.Add({ start, end - start });
+
+		for (auto i = _changedRanges.Count() - 1; i > first; i--)
+			std::swap(_changedRanges.Item(i), _changedRanges.Item(i - 1));
+	}
+	else
+	{
+		_changedRanges.Item(first) = { start, end - start };
+
+		for (auto i = first + 1; i < last; i++)
+			_changedRanges.RemoveAt(first + 1);
+	}
+
+	if (_changedRanges.Count() > _maximumChangedRanges)
+	{
+		auto& range = _changedRanges.First();
+		range.Size = _changedRanges.Last().Start + _changedRanges.Last().Size - range.Start;
+
+		while (_changedRanges.Count() > 1)
+			_changedRanges.RemoveAt(_changedRanges.Count() - 1);
+	}
+}
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "Pargon/Graphics/GraphicsDevice.h"
 #include "Pargon/Types/Color.h"
 
+#include <algorithm>
+#include <chrono>
+
 using namespace Pargon;
 
 auto GraphicsDevice::Setup(Application& application, std::unique_ptr<Pargon::Renderer>&& renderer) -> RendererInformation
@@ -23,340 +26,1800 @@ auto GraphicsDevice::Setup(Application& application, std::unique_ptr<Pargon::Ren
 	return information;
 }
 
-auto GraphicsDevice::CreateGeometry(GraphicsStorage storage) -> Geometry*
+GraphicsDevice::~GraphicsDevice()
+{
+	StopRenderThread();
+}
+
+void GraphicsDevice::StartRenderThread(int framesInFlight)
+{
+	assert(!_renderThread.joinable());
+	assert(framesInFlight > 0);
+
+	while (_frames.Count() < framesInFlight)
+		_frames.Add(std::make_unique<Frame>());
+
+	_availableFrames.Reset(framesInFlight + 1);
+	_submittedFrames.Reset(framesInFlight + 1);
+
+	for (auto i = 0; i < framesInFlight; i++)
+		_availableFrames.Push(i);
+
+	_framesInFlight = framesInFlight;
+	_renderThread = std::thread([this]() { RenderFrames(); });
+}
+
+void GraphicsDevice::StopRenderThread()
+{
+	if (_renderThread.joinable())
+	{
+		_submittedFrames.Push(_stopFrame);
+		_renderThread.join();
+		_framesInFlight = 0;
+
+		for (auto& frame : _frames)
+			ReleaseRetired(*frame);
+	}
+}
+
+void GraphicsDevice::SetAutomaticInstancing(int constantBufferSlot)
+{
+	_automaticInstancing = constantBufferSlot;
+}
+
+void GraphicsDevice::SetUploadElision(bool enabled)
+{
+	_uploadElision = enabled;
+}
+
+void GraphicsDevice::SetUploadBudget(std::size_t bytes, double milliseconds)
+{
+	_uploadByteBudget = bytes;
+	_uploadTimeBudget = milliseconds;
+}
+
+void GraphicsDevice::SetPoolLimit(int count)
 {
 	std::lock_guard<std::mutex> lock(_resourceGuard);
 
-	auto id = _nextGeometryId++;
+	assert(count >= 0);
 
-	assert(_renderer);
-	assert(_geometries.GetIndex(id) == Sequence::InvalidIndex);
+	_poolLimit = count;
 
-	return _geometries.AddOrSet(id, std::unique_ptr<Geometry>(new Geometry(*this, storage, _renderer->CreateGeometryHandle(), id))).get();
+	if (_poolLimit == PoolingDisabled)
+	{
+		_geometryPools.Clear();
+		_texturePools.Clear();
+	}
 }
 
-void GraphicsDevice::DestroyGeometry(GeometryId id)
+void GraphicsDevice::SetDrawSorting(bool enabled)
+{
+	_drawSorting = enabled;
+}
+
+void GraphicsDevice::SetCommandOptimization(bool enabled)
+{
+	_commandOptimization = enabled;
+}
+
+auto GraphicsDevice::CreateGeometry(GraphicsStorage storage) -> Geometry*
 {
 	std::lock_guard<std::mutex> lock(_resourceGuard);
 
 	assert(_renderer);
-	assert(_geometries.GetIndex(id._id) != Sequence::InvalidIndex);
-	assert(!GetGeometry(id)->IsLocked());
-	assert(!GetGeometry(id)->IsChanged());
+	assert(storage != GraphicsStorage::FrameTransient);
+
+	return _geometries.Create([&](GeometryId id)
+	{
+		return std::unique_ptr<Geometry>(new Geometry(*this, storage, _renderer->CreateGeometryHandle(), id));
+	});
+}
+
+namespace
+{
+	auto GetCapacityClass(std::size_t capacity, bool roundUp) -> int
+	{
+		auto capacityClass = 0;
+
+		while ((std::size_t(1) << (capacityClass + 1)) <= capacity)
+			capacityClass++;
+
+		if (roundUp && (std::size_t(1) << capacityClass) < capacity)
+			capacityClass++;
+
+		return capacityClass;
+	}
+}
+
+auto GraphicsDevice::CreateGeometry(GraphicsStorage storage, GeometryTopology topology, int capacity) -> Geometry*
+{
+	std::unique_lock<std::mutex> lock(_resourceGuard);
+
+	auto pool = GetGeometryPool(storage, GetCapacityClass(capacity, true), false);
+
+	if (pool == nullptr || pool->Geometries.IsEmpty())
+	{
+		lock.unlock();
+
+		auto geometry = CreateGeometry(storage);
+		geometry->Reset(topology, capacity);
+		return geometry;
+	}
+
+	auto geometry = _geometries.Create([&](GeometryId id)
+	{
+		auto pooled = std::move(pool->Geometries.Last());
+		pool->Geometries.RemoveAt(pool->Geometries.Count() - 1);
+		pooled->Recycle(id);
+		return pooled;
+	});
+
+	lock.unlock();
+
+	geometry->Reset(topology, capacity);
+	return geometry;
+}
+
+void GraphicsDevice::DestroyGeometry(GeometryId id)
+{
+	auto geometry = GetGeometry(id);
 
-	_geometries.RemoveWithKey(id._id);
+	assert(geometry != nullptr);
+	assert(geometry->Storage() != GraphicsStorage::FrameTransient);
+
+	geometry->Retire();
+
+	std::lock_guard<std::mutex> lock(_retireGuard);
+	_retired.Geometries.Add(id);
 }
 
 auto GraphicsDevice::GetGeometry(GeometryId id) -> Geometry*
 {
-	auto index = _geometries.GetIndex(id._id);
-	return index == Sequence::InvalidIndex ? nullptr : _geometries.ItemAtIndex(index).get();
+	return _geometries.Get(id);
 }
 
 auto GraphicsDevice::CreateMaterial(GraphicsStorage storage) -> Material*
 {
 	std::lock_guard<std::mutex> lock(_resourceGuard);
 
-	auto id = _nextMaterialId++;
-
 	assert(_renderer);
-	assert(_materials.GetIndex(id) == Sequence::InvalidIndex);
+	assert(storage != GraphicsStorage::FrameTransient);
 
-	return _materials.AddOrSet(id, std::unique_ptr<Material>(new Material(*this, storage, _renderer->CreateMaterialHandle(), id))).get();
+	return _materials.Create([&](MaterialId id)
+	{
+		return std::unique_ptr<Material>(new Material(*this, storage, _renderer->CreateMaterialHandle(), id));
+	});
 }
 
 void GraphicsDevice::DestroyMaterial(MaterialId id)
 {
-	std::lock_guard<std::mutex> lock(_resourceGuard);
+	auto material = GetMaterial(id);
 
-	assert(_renderer);
-	assert(_materials.GetIndex(id._id) != Sequence::InvalidIndex);
-	assert(!GetMaterial(id)->IsLocked());
-	assert(!GetMaterial(id)->IsChanged());
+	assert(material != nullptr);
+	assert(material->Storage() != GraphicsStorage::FrameTransient);
 
-	_materials.RemoveWithKey(id._id);
+	material->Retire();
+
+	std::lock_guard<std::mutex> lock(_retireGuard);
+	_retired.Materials.Add(id);
 }
 
 auto GraphicsDevice::GetMaterial(MaterialId id) -> Material*
 {
-	auto index = _materials.GetIndex(id._id);
-	return index == Sequence::InvalidIndex ? nullptr : _materials.ItemAtIndex(index).get();
+	return _materials.Get(id);
 }
 
 auto GraphicsDevice::CreateTexture(GraphicsStorage storage) -> Texture*
 {
 	std::lock_guard<std::mutex> lock(_resourceGuard);
 
-	auto id = _nextTextureId++;
-
 	assert(_renderer);
-	assert(_textures.GetIndex(id) == Sequence::InvalidIndex);
+	assert(storage != GraphicsStorage::FrameTransient);
+
+	return _textures.Create([&](TextureId id)
+	{
+		return std::unique_ptr<Texture>(new Texture(*this, storage, _renderer->CreateTextureHandle(), id));
+	});
+}
+
+auto GraphicsDevice::CreateTexture(GraphicsStorage storage, TextureSize size, TextureFormat format) -> Texture*
+{
+	std::unique_lock<std::mutex> lock(_resourceGuard);
+
+	auto pool = GetTexturePool(storage, size, format, false);
+
+	if (pool == nullptr || pool->Textures.IsEmpty())
+	{
+		lock.unlock();
 
-	return _textures.AddOrSet(id, std::unique_ptr<Texture>(new Texture(*this, storage, _renderer->CreateTextureHandle(), id))).get();
+		auto texture = CreateTexture(storage);
+		texture->Reset(size, format, {});
+		return texture;
+	}
+
+	auto texture = _textures.Create([&](TextureId id)
+	{
+		auto pooled = std::move(pool->Textures.Last());
+		pool->Textures.RemoveAt(pool->Textures.Count() - 1);
+		pooled->Recycle(id);
+		return pooled;
+	});
+
+	lock.unlock();
+
+	texture->Reset(size, format, {});
+	return texture;
 }
 
 void GraphicsDevice::DestroyTexture(TextureId id)
 {
-	std::lock_guard<std::mutex> lock(_resourceGuard);
+	auto texture = GetTexture(id);
 
-	assert(_renderer);
-	assert(_textures.GetIndex(id._id) != Sequence::InvalidIndex);
-	assert(!GetTexture(id)->IsLocked());
-	assert(!GetTexture(id)->IsChanged());
+	assert(texture != nullptr);
+	assert(texture->Storage() != GraphicsStorage::FrameTransient);
+
+	texture->Retire();
 
-	_textures.RemoveWithKey(id._id);
+	std::lock_guard<std::mutex> lock(_retireGuard);
+	_retired.Textures.Add(id);
 }
 
 auto GraphicsDevice::GetTexture(TextureId id) -> Texture*
 {
-	auto index = _textures.GetIndex(id._id);
-	return index == Sequence::InvalidIndex ? nullptr : _textures.ItemAtIndex(index).get();
+	return _textures.Get(id);
+}
+
+auto GraphicsDevice::GetTransientGeometry(GeometryTopology topology) -> Geometry*
+{
+	assert(topology != GeometryTopology::Unknown);
+
+	auto& geometry = _transients.Item(static_cast<int>(topology));
+
+	if (geometry == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(_resourceGuard);
+
+		assert(_renderer);
+
+		geometry = _geometries.Create([&](GeometryId id)
+		{
+			return std::unique_ptr<Geometry>(new Geometry(*this, GraphicsStorage::FrameTransient, _renderer->CreateGeometryHandle(), id));
+		});
+
+		geometry->Reset(topology, 0);
+	}
+
+	return geometry;
 }
 
 void GraphicsDevice::SetColorTarget(TextureId texture, int slot)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetColorTarget;
-	command.Data.SetColorTarget.Texture = texture;
-	command.Data.SetColorTarget.Slot = slot;
+	_commandQueue.SetColorTarget(texture, slot);
 }
 
 void GraphicsDevice::ClearColorTarget(float red, float green, float blue, float alpha)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::ClearColorTarget;
-	command.Data.ClearColorTarget.R = red;
-	command.Data.ClearColorTarget.G = green;
-	command.Data.ClearColorTarget.B = blue;
-	command.Data.ClearColorTarget.A = alpha;
+	_commandQueue.ClearColorTarget(red, green, blue, alpha);
 }
 
 void GraphicsDevice::SetDepthStencilTarget(TextureId texture)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetDepthStencilTarget;
-	command.Data.SetDepthStencilTarget.Texture = texture;
+	_commandQueue.SetDepthStencilTarget(texture);
 }
 
 void GraphicsDevice::ClearDepthStencilTarget(float depthValue, int stencilValue)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::ClearDepthStencilTarget;
-	command.Data.ClearDepthStencilTarget.DepthValue = depthValue;
-	command.Data.ClearDepthStencilTarget.StencilValue = stencilValue;
+	_commandQueue.ClearDepthStencilTarget(depthValue, stencilValue);
 }
 
 void GraphicsDevice::SetClippingRectangle(float x, float y, float width, float height)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetClippingRectangle;
-	command.Data.SetClippingRectangle.X = x;
-	command.Data.SetClippingRectangle.Y = y;
-	command.Data.SetClippingRectangle.Width = width;
-	command.Data.SetClippingRectangle.Height = height;
+	_commandQueue.SetClippingRectangle(x, y, width, height);
 }
 
 void GraphicsDevice::SetMaterial(MaterialId material)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetMaterial;
-	command.Data.SetMaterial.Material = material;
+	_commandQueue.SetMaterial(material);
 }
 
 void GraphicsDevice::SetTexture(TextureId texture, int slot)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetTexture;
-	command.Data.SetTexture.Texture = texture;
-	command.Data.SetTexture.Slot = slot;
+	_commandQueue.SetTexture(texture, slot);
 }
 
 void GraphicsDevice::SetVertexBuffer(GeometryId geometry, std::size_t vertexSize)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetVertexBuffer;
-	command.Data.SetVertexBuffer.Geometry = geometry;
-	command.Data.SetVertexBuffer.VertexSize = vertexSize;
+	_commandQueue.SetVertexBuffer(geometry, vertexSize);
+}
+
+void GraphicsDevice::SetVertexStream(GeometryId geometry, std::size_t vertexSize, int stream)
+{
+	_commandQueue.SetVertexStream(geometry, vertexSize, stream);
 }
 
 void GraphicsDevice::SetInstanceBuffer(GeometryId geometry, std::size_t instanceSize)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetInstanceBuffer;
-	command.Data.SetInstanceBuffer.Geometry = geometry;
-	command.Data.SetInstanceBuffer.InstanceSize = instanceSize;
+	_commandQueue.SetInstanceBuffer(geometry, instanceSize);
 }
 
 void GraphicsDevice::SetIndexBuffer(GeometryId geometry, std::size_t indexSize)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetIndexBuffer;
-	command.Data.SetIndexBuffer.Geometry = geometry;
-	command.Data.SetIndexBuffer.IndexSize = indexSize;
+	_commandQueue.SetIndexBuffer(geometry, indexSize);
 }
 
 void GraphicsDevice::SetConstantBuffer(GeometryId geometry, bool vertexAccess, bool fragmentAccess, int start, std::size_t size, int slot)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::SetConstantBuffer;
-	command.Data.SetConstantBuffer.Geometry = geometry;
-	command.Data.SetConstantBuffer.Start = start;
-	command.Data.SetConstantBuffer.Size = size;
-	command.Data.SetConstantBuffer.Slot = slot;
-	command.Data.SetConstantBuffer.VertexAccess = vertexAccess;
-	command.Data.SetConstantBuffer.FragmentAccess = fragmentAccess;
+	_commandQueue.SetConstantBuffer(geometry, vertexAccess, fragmentAccess, start, size, slot);
 }
 
 void GraphicsDevice::Draw(int start, int count)
 {
-	auto& command = _commandQueue.Increment();
-	command.Type = RenderCommandType::Draw;
-	command.Data.Draw.Start = start;
-	command.Data.Draw.Count = count;
+	_commandQueue.Draw(start, count);
+}
+
+void GraphicsDevice::MultiDraw(SequenceView<DrawRange> ranges)
+{
+	_commandQueue.MultiDraw(ranges);
+}
+
+void GraphicsDevice::SetLayer(int layer)
+{
+	_commandQueue.SetLayer(layer);
+}
+
+void GraphicsDevice::Replay(const CommandBundle& bundle)
+{
+	_commandQueue.Replay(bundle);
+}
+
+void GraphicsDevice::Submit(CommandList& commands)
+{
+	_commandQueue.ExecuteCommandList(commands);
+	_submittedCommands.Add(std::addressof(commands));
 }
 
 void GraphicsDevice::Render(int synchronization)
 {
 	assert(_renderer);
 
-	std::lock_guard<std::mutex> lock(_resourceGuard);
-
-	for (auto resource : _pendingUpdates)
+	if (_renderThread.joinable())
 	{
-		if (!resource->_isLocked)
-			resource->_handle->Update(resource);
-	}
+		auto index = _availableFrames.Pop();
+		auto& frame = *_frames.Item(index);
 
-	_renderer->BeginFrame();
+		if (frame.Completed)
+			_statistics = frame.Statistics;
 
-	for (auto& command : _commandQueue)
+		ReleaseRetired(frame);
+		PrepareFrame(frame, synchronization);
+		_submittedFrames.Push(index);
+	}
+	else
 	{
-		switch (command.Type)
-		{
-		case RenderCommandType::SetColorTarget: ExecuteCommand(command.Data.SetColorTarget); break;
-		case RenderCommandType::ClearColorTarget: ExecuteCommand(command.Data.ClearColorTarget); break;
-		case RenderCommandType::SetDepthStencilTarget: ExecuteCommand(command.Data.SetDepthStencilTarget); break;
-		case RenderCommandType::ClearDepthStencilTarget: ExecuteCommand(command.Data.ClearDepthStencilTarget); break;
-		case RenderCommandType::SetClippingRectangle: ExecuteCommand(command.Data.SetClippingRectangle); break;
-		case RenderCommandType::SetMaterial: ExecuteCommand(command.Data.SetMaterial); break;
-		case RenderCommandType::SetTexture: ExecuteCommand(command.Data.SetTexture); break;
-		case RenderCommandType::SetVertexBuffer: ExecuteCommand(command.Data.SetVertexBuffer); break;
-		case RenderCommandType::SetInstanceBuffer: ExecuteCommand(command.Data.SetInstanceBuffer); break;
-		case RenderCommandType::SetIndexBuffer: ExecuteCommand(command.Data.SetIndexBuffer); break;
-		case RenderCommandType::SetConstantBuffer: ExecuteCommand(command.Data.SetConstantBuffer); break;
-		case RenderCommandType::Draw: ExecuteCommand(command.Data.Draw); break;
-		}
+		if (_frames.IsEmpty())
+			_frames.Add(std::make_unique<Frame>());
+
+		auto& frame = *_frames.Item(0);
+
+		PrepareFrame(frame, synchronization);
+		ProcessFrame(frame);
+		ReleaseRetired(frame);
+
+		_statistics = frame.Statistics;
 	}
+}
 
-	_renderer->EndFrame(synchronization);
+void GraphicsDevice::QueueUpdate(GraphicsResource_* resource)
+{
+	auto head = _pendingUpdates.load(std::memory_order_relaxed);
 
-	_vertexCount = 0;
-	_indexCount = 0;
-	_instanceCount = 0;
+	do
+	{
+		resource->_nextUpdate = head;
+	}
+	while (!_pendingUpdates.compare_exchange_weak(head, resource, std::memory_order_release, std::memory_order_relaxed));
+}
 
-	_commandQueue.Clear();
+void GraphicsDevice::TakeUpdates(List<GraphicsResource_*>& updates)
+{
+	auto first = updates.Count();
 
-	for (auto resource : _pendingUpdates)
+	for (auto resource = _pendingUpdates.exchange(nullptr, std::memory_order_acquire); resource != nullptr; resource = resource->_nextUpdate)
 	{
-		if (!resource->_isLocked)
-			resource->UpdateComplete();
+		if (!resource->IsRetired())
+			updates.Add(resource);
 	}
 
-	_pendingUpdates.Clear();
+	std::reverse(updates.begin() + first, updates.end());
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetColorTarget& command)
+void GraphicsDevice::ReleaseRetired(Frame& frame)
 {
-	auto texture = GetTexture(command.Texture);
-	_renderer->SetRenderTarget(texture, command.Slot);
+	auto& retired = frame.Retired;
+
+	if (retired.Geometries.IsEmpty() && retired.Materials.IsEmpty() && retired.Textures.IsEmpty())
+		return;
+
+	std::unique_lock<std::mutex> lock(_resourceGuard);
+
+	for (auto id : retired.Geometries)
+		PoolGeometry(_geometries.Remove(id));
+
+	for (auto id : retired.Materials)
+		_releasedResources.Add(_materials.Remove(id));
+
+	for (auto id : retired.Textures)
+		PoolTexture(_textures.Remove(id));
+
+	_resourceRevision++;
+
+	lock.unlock();
+
+	_releasedResources.Clear();
+	retired.Geometries.Clear();
+	retired.Materials.Clear();
+	retired.Textures.Clear();
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::ClearColorTarget& command)
+auto GraphicsDevice::GetGeometryPool(GraphicsStorage storage, int capacityClass, bool create) -> GeometryPool*
 {
-	_renderer->ClearColorTarget(command.R, command.G, command.B, command.A);
+	if (_poolLimit == PoolingDisabled)
+		return nullptr;
+
+	for (auto& pool : _geometryPools)
+	{
+		if (pool.Storage == storage && pool.CapacityClass == capacityClass)
+			return std::addressof(pool);
+	}
+
+	if (!create)
+		return nullptr;
+
+	auto& pool = _geometryPools.Increment();
+	pool.Storage = storage;
+	pool.CapacityClass = capacityClass;
+	return std::addressof(pool);
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetDepthStencilTarget& command)
+auto GraphicsDevice::GetTexturePool(GraphicsStorage storage, TextureSize size, TextureFormat format, bool create) -> TexturePool*
 {
-	auto texture = GetTexture(command.Texture);
-	_renderer->SetDepthStencilTarget(texture);
+	if (_poolLimit == PoolingDisabled || format == TextureFormat::Unknown)
+		return nullptr;
+
+	for (auto& pool : _texturePools)
+	{
+		if (pool.Storage == storage && pool.Size.Width == size.Width && pool.Size.Height == size.Height && pool.Format == format)
+			return std::addressof(pool);
+	}
+
+	if (!create)
+		return nullptr;
+
+	auto& pool = _texturePools.Increment();
+	pool.Storage = storage;
+	pool.Size = size;
+	pool.Format = format;
+	return std::addressof(pool);
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::ClearDepthStencilTarget& command)
+void GraphicsDevice::PoolGeometry(std::unique_ptr<Geometry>&& geometry)
 {
-	_renderer->ClearDepthAndStencilTarget(command.DepthValue, command.StencilValue);
+	auto pool = GetGeometryPool(geometry->Storage(), GetCapacityClass(geometry->Size(), false), true);
+
+	if (pool != nullptr && pool->Geometries.Count() < _poolLimit)
+		pool->Geometries.Add(std::move(geometry));
+	else
+		_releasedResources.Add(std::move(geometry));
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetClippingRectangle& command)
+void GraphicsDevice::PoolTexture(std::unique_ptr<Texture>&& texture)
 {
-	_renderer->SetClippingRectangle(command.X, command.Y, command.Width, command.Height);
+	auto pool = texture->SampleCount() > 1 ? nullptr : GetTexturePool(texture->Storage(), texture->Size(), texture->Format(), true);
+
+	if (pool != nullptr && pool->Textures.Count() < _poolLimit)
+		pool->Textures.Add(std::move(texture));
+	else
+		_releasedResources.Add(std::move(texture));
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetMaterial& command)
+void GraphicsDevice::ProcessUploads(const Frame& frame)
 {
-	auto material = GetMaterial(command.Material);
-	_renderer->SetMaterial(material);
+	auto queued = 0;
+
+	for (auto resource : _uploadQueue)
+	{
+		if (!resource->IsRetired())
+			_uploadQueue.Item(queued++) = resource;
+	}
+
+	_uploadQueue.SetCount(queued);
+
+	for (auto resource : frame.PendingUpdates)
+	{
+		if (!resource->IsRetired())
+			_uploadQueue.Add(resource);
+	}
+
+	std::stable_sort(_uploadQueue.begin(), _uploadQueue.end(), [](GraphicsResource_* left, GraphicsResource_* right)
+	{
+		return left->UploadPriority() > right->UploadPriority();
+	});
+
+	auto start = std::chrono::steady_clock::now();
+	auto uploads = 0;
+	auto remaining = 0;
+
+	for (auto i = 0; i < _uploadQueue.Count(); i++)
+	{
+		auto resource = _uploadQueue.Item(i);
+
+		if (resource->IsRetired())
+			continue;
+
+		auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		auto overBytes = frame.UploadByteBudget != UnlimitedUploadBytes && _frameStatistics.UploadedBytes >= frame.UploadByteBudget;
+		auto overTime = frame.UploadTimeBudget != UnlimitedUploadTime && elapsed >= frame.UploadTimeBudget;
+
+		if ((uploads == 0 || (!overBytes && !overTime)) && resource->BeginUpdate())
+		{
+			_frameStatistics.UploadedBytes += resource->UploadSource()->ContentSize();
+			resource->_handle->Update(resource->UploadSource());
+			resource->UpdateComplete();
+			uploads++;
+		}
+		else
+		{
+			_frameStatistics.QueuedUploadBytes += resource->UploadSource()->ContentSize();
+			_uploadQueue.Item(remaining++) = resource;
+		}
+	}
+
+	_uploadQueue.SetCount(remaining);
+	_frameStatistics.QueuedUploads = remaining;
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetTexture& command)
+namespace
 {
-	auto texture = GetTexture(command.Texture);
-	_renderer->SetTexture(texture, command.Slot);
+	template<typename CaptureType>
+	auto IsCapturedBefore(const CaptureType& left, const CaptureType& right) -> bool
+	{
+		if (left.Geometry != right.Geometry)
+			return left.Geometry < right.Geometry;
+
+		if (left.Start != right.Start)
+			return left.Start < right.Start;
+
+		return left.Size < right.Size;
+	}
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetVertexBuffer& command)
+void GraphicsDevice::PrepareFrame(Frame& frame, int synchronization)
 {
-	auto geometry = GetGeometry(command.Geometry);
-	auto size = command.VertexSize;
+	std::swap(frame.Commands, _commandQueue);
 
-	_vertexCount = geometry == nullptr || size == 0 ? 0 : static_cast<int>(geometry->Size() / size);
-	_indexCount = 0;
-	_instanceCount = 0;
+	frame.RecordedCommands = frame.Commands.Count() - _submittedCommands.Count();
+	frame.Synchronization = synchronization;
+	frame.DrawSorting = _drawSorting;
+	frame.CommandOptimization = _commandOptimization;
+	frame.AutomaticInstancing = _automaticInstancing;
+	frame.UploadByteBudget = _uploadByteBudget;
+	frame.UploadTimeBudget = _uploadTimeBudget;
+	frame.Completed = false;
+
+	auto submission = 0;
+
+	for (auto encoded = frame.Commands.Begin(); encoded != frame.Commands.End(); encoded = CommandList::Next(encoded))
+	{
+		if (CommandList::GetType(encoded) != RenderCommandType::ExecuteCommandList)
+			continue;
+
+		if (frame.SubmittedCommands.Count() == submission)
+			frame.SubmittedCommands.Add(std::make_unique<CommandList>());
+
+		auto source = _submittedCommands.Item(submission);
+		auto first = 0;
+
+		while (_submittedCommands.Item(first) != source)
+			first++;
+
+		if (first == submission)
+			std::swap(*frame.SubmittedCommands.Item(submission), *source);
+
+		auto command = CommandList::Read(encoded);
+		auto commands = frame.SubmittedCommands.Item(first).get();
+
+		command.Data.ExecuteCommandList.Commands = commands;
+		frame.Commands.Overwrite(static_cast<int>(encoded - frame.Commands.Begin()), command);
+		frame.RecordedCommands += commands->Count();
+		submission++;
+	}
+
+	_submittedCommands.Clear();
+
+	if (frame.AutomaticInstancing != InstancingDisabled)
+	{
+		CaptureInstanceConstants(frame.Commands, frame);
+		std::sort(frame.InstanceConstants.begin(), frame.InstanceConstants.end(), IsCapturedBefore<CapturedConstants>);
+	}
 
-	_renderer->SetVertexBuffer(geometry, size);
+	TakeUpdates(frame.PendingUpdates);
+	std::swap(frame.Transients, _transients);
+
+	{
+		std::lock_guard<std::mutex> lock(_retireGuard);
+		std::swap(frame.Retired, _retired);
+	}
+
+	for (auto geometry : _transients)
+	{
+		if (geometry != nullptr)
+			geometry->Reset(geometry->Topology(), 0);
+	}
+
+	frame.SkippedUploadBytes = _skippedUploadBytes.exchange(0, std::memory_order_relaxed);
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetInstanceBuffer& command)
+void GraphicsDevice::ProcessFrame(Frame& frame)
 {
-	auto geometry = GetGeometry(command.Geometry);
-	auto size = command.InstanceSize;
+	std::unique_lock<std::mutex> lock(_resourceGuard);
+
+	_frameStatistics = {};
+	_frameStatistics.RecordedCommands = frame.RecordedCommands;
+	_frameStatistics.SkippedUploadBytes = frame.SkippedUploadBytes;
+
+	ProcessUploads(frame);
+
+	for (auto geometry : frame.Transients)
+	{
+		if (geometry == nullptr)
+			continue;
+
+		if (geometry->Size() > 0)
+			geometry->_handle->Update(geometry);
+
+		geometry->_uploadedSize = geometry->Size();
+	}
 
-	_instanceCount = geometry == nullptr || size == 0 ? 0 : static_cast<int>(geometry->Size() / size);
+	_renderer->BeginFrame();
+
+	const CommandList* commands = std::addressof(frame.Commands);
+
+	if (frame.DrawSorting)
+	{
+		SortCommands(*commands);
+		commands = std::addressof(_sortedQueue);
+	}
+
+	if (frame.CommandOptimization)
+	{
+		OptimizeCommands(*commands);
+		commands = std::addressof(_optimizedQueue);
+	}
+
+	ResetInstancing(frame);
+	TranslateCommands(*commands);
+	ResolveDrawRanges();
+	UploadInstances();
+
+	_renderer->Execute(_renderPackets);
+
+	lock.unlock();
+
+	_renderer->EndFrame(frame.Synchronization);
+
+	_vertexCount = 0;
+	_indexCount = 0;
+	_instanceCount = 0;
 
-	_renderer->SetInstanceBuffer(geometry, size);
+	_sortedQueue.Clear();
+	_optimizedQueue.Clear();
+	_frameCommands.Clear();
+	_renderPackets.Clear();
+	_drawRanges.Clear();
+
+	frame.Commands.Clear();
+	frame.PendingUpdates.Clear();
+	frame.InstanceConstants.Clear();
+	frame.InstanceDataSize = 0;
+
+	for (auto& submitted : frame.SubmittedCommands)
+		submitted->Clear();
+
+	frame.Statistics = _frameStatistics;
+	frame.Completed = true;
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetIndexBuffer& command)
+void GraphicsDevice::RenderFrames()
 {
-	auto geometry = GetGeometry(command.Geometry);
-	auto size = command.IndexSize;
+	while (true)
+	{
+		auto index = _submittedFrames.Pop();
 
-	_indexCount = geometry == nullptr || size == 0 ? 0 : static_cast<int>(geometry->Size() / size);
+		if (index == _stopFrame)
+			break;
 
-	_renderer->SetIndexBuffer(geometry, size);
+		ProcessFrame(*_frames.Item(index));
+		_availableFrames.Push(index);
+	}
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::SetConstantBuffer& command)
+void GraphicsDevice::FrameQueue::Reset(int capacity)
 {
-	auto geometry = GetGeometry(command.Geometry);
-
-	_renderer->SetConstantBuffer(geometry, command.VertexAccess, command.FragmentAccess, command.Start, command.Size, command.Slot);
+	_frames.SetCount(capacity, _stopFrame);
+	_head.store(0, std::memory_order_relaxed);
+	_tail.store(0, std::memory_order_relaxed);
 }
 
-void GraphicsDevice::ExecuteCommand(const RenderCommand::Draw& command)
+void GraphicsDevice::FrameQueue::Push(int frame)
 {
-	if (_instanceCount > 0)
+	auto tail = _tail.load(std::memory_order_relaxed);
+	auto next = (tail + 1) % _frames.Count();
+
+	assert(next != _head.load(std::memory_order_acquire));
+
+	_frames.Item(tail) = frame;
+	_tail.store(next, std::memory_order_release);
+
 	{
-		if (_indexCount > 0)
-			_renderer->DrawIndexedInstances(0, _indexCount, command.Start, command.Count == 0 ? _instanceCount : command.Count);
-		else
-			_renderer->DrawInstances(0, _vertexCount, command.Start, command.Count == 0 ? _instanceCount : command.Count);
+		std::lock_guard<std::mutex> lock(_signalGuard);
 	}
-	else
-	{
-		if (_indexCount > 0)
-			_renderer->DrawIndices(command.Start, command.Count == 0 ? _indexCount : command.Count);
+
+	_signal.notify_one();
+}
+
+auto GraphicsDevice::FrameQueue::Pop() -> int
+{
+	auto head = _head.load(std::memory_order_relaxed);
+
+	if (_tail.load(std::memory_order_acquire) == head)
+	{
+		std::unique_lock<std::mutex> lock(_signalGuard);
+		_signal.wait(lock, [&]() { return _tail.load(std::memory_order_acquire) != head; });
+	}
+
+	auto frame = _frames.Item(head);
+	_head.store((head + 1) % _frames.Count(), std::memory_order_release);
+	return frame;
+}
+
+namespace
+{
+	template<typename PacketType>
+	void SortPackets(List<PacketType>& packets, List<PacketType>& scratch)
+	{
+		scratch.SetCount(packets.Count(), PacketType{});
+
+		for (auto shift = 0; shift < 64; shift += 8)
+		{
+			Array<int, 256> offsets = {{ 0 }};
+
+			for (auto& packet : packets)
+				offsets.Item(static_cast<int>((packet.Key >> shift) & 0xFF))++;
+
+			if (offsets.Item(static_cast<int>((packets.First().Key >> shift) & 0xFF)) == packets.Count())
+				continue;
+
+			auto total = 0;
+
+			for (auto& offset : offsets)
+			{
+				auto count = offset;
+				offset = total;
+				total += count;
+			}
+
+			for (auto& packet : packets)
+				scratch.Item(offsets.Item(static_cast<int>((packet.Key >> shift) & 0xFF))++) = packet;
+
+			std::swap(packets, scratch);
+		}
+	}
+
+	auto GetSortField(int value) -> std::uint64_t
+	{
+		return static_cast<std::uint64_t>(value) & 0xFFFF;
+	}
+
+	template<typename IdType>
+	auto GetSortField(IdType id) -> std::uint64_t
+	{
+		return GetSortField(id.Assignment());
+	}
+}
+
+void GraphicsDevice::FlattenCommands(const CommandList& commands)
+{
+	for (auto encoded = commands.Begin(); encoded != commands.End(); encoded = CommandList::Next(encoded))
+	{
+		auto type = CommandList::GetType(encoded);
+
+		if (type == RenderCommandType::ExecuteCommandList)
+		{
+			FlattenCommands(*CommandList::Read(encoded).Data.ExecuteCommandList.Commands);
+		}
+		else if (type == RenderCommandType::ExecuteCommandBundle)
+		{
+			auto bundle = CommandList::Read(encoded).Data.ExecuteCommandBundle.Bundle;
+
+			if (ValidateBundle(*bundle))
+				FlattenCommands(*bundle);
+			else
+				_frameStatistics.InvalidBundles++;
+		}
 		else
-			_renderer->DrawVertices(command.Start, command.Count == 0 ? _vertexCount : command.Count);
+		{
+			_frameCommands.Add(encoded);
+		}
+	}
+}
+
+void GraphicsDevice::SortCommands(const CommandList& commands)
+{
+	FlattenCommands(commands);
+
+	DrawState state;
+	state.Material = -1;
+	state.ClippingRectangle = -1;
+	state.VertexBuffer = -1;
+	state.InstanceBuffer = -1;
+	state.IndexBuffer = -1;
+
+	for (auto i = 0; i < MaximumVertexStreams; i++)
+		state.VertexStreams.Item(i) = -1;
+
+	for (auto i = 0; i < _sortedSlotCount; i++)
+	{
+		state.Textures.Item(i) = -1;
+		state.ConstantBuffers.Item(i) = -1;
+	}
+
+	auto emitted = state;
+	auto changed = true;
+	auto layer = 0;
+
+	for (auto i = 0; i < _frameCommands.Count(); i++)
+	{
+		auto command = CommandList::Read(_frameCommands.Item(i));
+
+		switch (command.Type)
+		{
+		case RenderCommandType::SetLayer:
+		{
+			layer = command.Data.SetLayer.Layer;
+			break;
+		}
+
+		case RenderCommandType::SetMaterial:
+		{
+			state.Material = i;
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::SetClippingRectangle:
+		{
+			state.ClippingRectangle = i;
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::SetVertexBuffer:
+		{
+			state.VertexBuffer = i;
+			state.InstanceBuffer = -1;
+			state.IndexBuffer = -1;
+
+			for (auto stream = 0; stream < MaximumVertexStreams; stream++)
+				state.VertexStreams.Item(stream) = -1;
+
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::SetVertexStream:
+		{
+			state.VertexStreams.Item(command.Data.SetVertexStream.Stream) = i;
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::SetInstanceBuffer:
+		{
+			state.InstanceBuffer = i;
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::SetIndexBuffer:
+		{
+			state.IndexBuffer = i;
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::SetTexture:
+		case RenderCommandType::SetConstantBuffer:
+		{
+			auto slot = command.Type == RenderCommandType::SetTexture ? command.Data.SetTexture.Slot : command.Data.SetConstantBuffer.Slot;
+			auto& slots = command.Type == RenderCommandType::SetTexture ? state.Textures : state.ConstantBuffers;
+
+			if (slot >= 0 && slot < _sortedSlotCount)
+			{
+				slots.Item(slot) = i;
+				changed = true;
+			}
+			else
+			{
+				FlushDrawPackets(emitted);
+				_sortedQueue.Append(_frameCommands.Item(i));
+				changed = true;
+			}
+
+			break;
+		}
+
+		case RenderCommandType::MultiDraw:
+		{
+			FlushDrawPackets(emitted);
+			EmitDrawState(state, emitted);
+			_sortedQueue.Append(_frameCommands.Item(i));
+			changed = true;
+			break;
+		}
+
+		case RenderCommandType::Draw:
+		{
+			if (changed)
+			{
+				_drawStates.Add(state);
+				changed = false;
+			}
+
+			auto material = state.Material == -1 ? MaterialId{} : CommandList::Read(_frameCommands.Item(state.Material)).Data.SetMaterial.Material;
+			auto texture = state.Textures.Item(0) == -1 ? TextureId{} : CommandList::Read(_frameCommands.Item(state.Textures.Item(0))).Data.SetTexture.Texture;
+			auto geometry = state.VertexBuffer == -1 ? GeometryId{} : CommandList::Read(_frameCommands.Item(state.VertexBuffer)).Data.SetVertexBuffer.Geometry;
+			auto key = (GetSortField(layer + 0x8000) << 48) | (GetSortField(material) << 32) | (GetSortField(texture) << 16) | GetSortField(geometry);
+
+			_drawPackets.Add({ key, i, _drawStates.Count() - 1 });
+			break;
+		}
+
+		default:
+		{
+			FlushDrawPackets(emitted);
+			_sortedQueue.Append(_frameCommands.Item(i));
+			changed = true;
+			break;
+		}
+		}
+	}
+
+	FlushDrawPackets(emitted);
+}
+
+void GraphicsDevice::FlushDrawPackets(DrawState& emitted)
+{
+	if (!_drawPackets.IsEmpty())
+	{
+		SortPackets(_drawPackets, _sortScratch);
+
+		for (auto& packet : _drawPackets)
+		{
+			EmitDrawState(_drawStates.Item(packet.State), emitted);
+			_sortedQueue.Append(_frameCommands.Item(packet.Draw));
+		}
+	}
+
+	_drawPackets.Clear();
+	_drawStates.Clear();
+}
+
+void GraphicsDevice::EmitDrawState(const DrawState& state, DrawState& emitted)
+{
+	auto emit = [this](int current, int previous)
+	{
+		if (current != previous && current != -1)
+			_sortedQueue.Append(_frameCommands.Item(current));
+	};
+
+	emit(state.Material, emitted.Material);
+	emit(state.ClippingRectangle, emitted.ClippingRectangle);
+
+	auto instanceCleared = state.InstanceBuffer == -1 && emitted.InstanceBuffer != -1;
+	auto indexCleared = state.IndexBuffer == -1 && emitted.IndexBuffer != -1;
+	auto streamCleared = false;
+
+	for (auto i = 1; i < MaximumVertexStreams; i++)
+		streamCleared = streamCleared || (state.VertexStreams.Item(i) == -1 && emitted.VertexStreams.Item(i) != -1);
+
+	if (state.VertexBuffer != emitted.VertexBuffer || instanceCleared || indexCleared || streamCleared)
+	{
+		emit(state.VertexBuffer, -1);
+
+		for (auto i = 1; i < MaximumVertexStreams; i++)
+			emit(state.VertexStreams.Item(i), -1);
+
+		emit(state.InstanceBuffer, -1);
+		emit(state.IndexBuffer, -1);
+	}
+	else
+	{
+		for (auto i = 1; i < MaximumVertexStreams; i++)
+			emit(state.VertexStreams.Item(i), emitted.VertexStreams.Item(i));
+
+		emit(state.InstanceBuffer, emitted.InstanceBuffer);
+		emit(state.IndexBuffer, emitted.IndexBuffer);
+	}
+
+	for (auto i = 0; i < _sortedSlotCount; i++)
+	{
+		emit(state.Textures.Item(i), emitted.Textures.Item(i));
+		emit(state.ConstantBuffers.Item(i), emitted.ConstantBuffers.Item(i));
+	}
+
+	emitted = state;
+}
+
+void GraphicsDevice::OptimizeCommands(const CommandList& commands)
+{
+	_boundState.Material = nullptr;
+	_boundState.ClippingRectangle = nullptr;
+	_boundState.VertexBuffer = nullptr;
+	_boundState.InstanceBuffer = nullptr;
+	_boundState.IndexBuffer = nullptr;
+	_boundState.DepthStencilTarget = nullptr;
+	_boundState.ColorClear = nullptr;
+	_boundState.DepthStencilClear = nullptr;
+	_boundState.ColorTargets.Clear();
+	_boundState.Textures.Clear();
+	_boundState.ConstantBuffers.Clear();
+	_boundState.LastDraw = -1;
+
+	for (auto i = 0; i < MaximumVertexStreams; i++)
+		_boundState.VertexStreams.Item(i) = nullptr;
+
+	for (auto encoded = commands.Begin(); encoded != commands.End(); encoded = CommandList::Next(encoded))
+		OptimizeCommand(encoded);
+
+	FlushClears();
+}
+
+void GraphicsDevice::OptimizeCommand(EncodedCommand encoded)
+{
+	auto& bound = _boundState;
+	auto command = CommandList::Read(encoded);
+
+	switch (command.Type)
+	{
+	case RenderCommandType::SetColorTarget:
+	{
+		auto slot = command.Data.SetColorTarget.Slot;
+
+		if (slot == bound.ColorTargets.Count() - 1 && IsBound(bound.ColorTargets.Item(slot), encoded))
+		{
+			_frameStatistics.RedundantCommands++;
+		}
+		else
+		{
+			FlushClears();
+			EmitOptimizedCommand(encoded);
+
+			bound.ColorTargets.SetCount(slot, nullptr);
+			bound.ColorTargets.Add(encoded);
+			bound.Textures.Clear();
+		}
+
+		break;
+	}
+
+	case RenderCommandType::SetDepthStencilTarget:
+	{
+		if (IsBound(bound.DepthStencilTarget, encoded))
+		{
+			_frameStatistics.RedundantCommands++;
+		}
+		else
+		{
+			FlushClears();
+			EmitOptimizedCommand(encoded);
+
+			bound.DepthStencilTarget = encoded;
+			bound.Textures.Clear();
+		}
+
+		break;
+	}
+
+	case RenderCommandType::ClearColorTarget:
+	case RenderCommandType::ClearDepthStencilTarget:
+	{
+		auto& clear = command.Type == RenderCommandType::ClearColorTarget ? bound.ColorClear : bound.DepthStencilClear;
+
+		if (clear != nullptr)
+			_frameStatistics.OverwrittenClears++;
+
+		clear = encoded;
+		break;
+	}
+
+	case RenderCommandType::SetClippingRectangle:
+	case RenderCommandType::SetMaterial:
+	case RenderCommandType::SetInstanceBuffer:
+	case RenderCommandType::SetIndexBuffer:
+	{
+		auto& current = command.Type == RenderCommandType::SetClippingRectangle ? bound.ClippingRectangle
+			: command.Type == RenderCommandType::SetMaterial ? bound.Material
+			: command.Type == RenderCommandType::SetInstanceBuffer ? bound.InstanceBuffer
+			: bound.IndexBuffer;
+
+		if (IsBound(current, encoded))
+		{
+			_frameStatistics.RedundantCommands++;
+		}
+		else
+		{
+			EmitOptimizedCommand(encoded);
+			current = encoded;
+		}
+
+		break;
+	}
+
+	case RenderCommandType::SetVertexBuffer:
+	{
+		auto streamsBound = false;
+
+		for (auto i = 0; i < MaximumVertexStreams; i++)
+			streamsBound = streamsBound || bound.VertexStreams.Item(i) != nullptr;
+
+		if (IsBound(bound.VertexBuffer, encoded) && bound.InstanceBuffer == nullptr && bound.IndexBuffer == nullptr && !streamsBound)
+		{
+			_frameStatistics.RedundantCommands++;
+		}
+		else
+		{
+			EmitOptimizedCommand(encoded);
+
+			bound.VertexBuffer = encoded;
+			bound.InstanceBuffer = nullptr;
+			bound.IndexBuffer = nullptr;
+
+			for (auto i = 0; i < MaximumVertexStreams; i++)
+				bound.VertexStreams.Item(i) = nullptr;
+		}
+
+		break;
+	}
+
+	case RenderCommandType::SetVertexStream:
+	{
+		auto& current = bound.VertexStreams.Item(command.Data.SetVertexStream.Stream);
+
+		if (IsBound(current, encoded))
+		{
+			_frameStatistics.RedundantCommands++;
+		}
+		else
+		{
+			EmitOptimizedCommand(encoded);
+			current = encoded;
+		}
+
+		break;
+	}
+
+	case RenderCommandType::SetTexture:
+	case RenderCommandType::SetConstantBuffer:
+	{
+		auto slot = command.Type == RenderCommandType::SetTexture ? command.Data.SetTexture.Slot : command.Data.SetConstantBuffer.Slot;
+		auto& slots = command.Type == RenderCommandType::SetTexture ? bound.Textures : bound.ConstantBuffers;
+
+		if (slot < slots.Count() && IsBound(slots.Item(slot), encoded))
+		{
+			_frameStatistics.RedundantCommands++;
+		}
+		else
+		{
+			EmitOptimizedCommand(encoded);
+
+			if (slot >= slots.Count())
+				slots.SetCount(slot + 1, nullptr);
+
+			slots.Item(slot) = encoded;
+		}
+
+		break;
+	}
+
+	case RenderCommandType::Draw:
+	{
+		FlushClears();
+
+		if (bound.LastDraw != -1)
+		{
+			auto previous = CommandList::Read(_optimizedQueue.Begin() + bound.LastDraw);
+
+			if (CanMergeDraws(previous.Data.Draw, command.Data.Draw))
+			{
+				previous.Data.Draw.Count += command.Data.Draw.Count;
+				_optimizedQueue.Overwrite(bound.LastDraw, previous);
+				_frameStatistics.MergedDraws++;
+				break;
+			}
+		}
+
+		auto offset = _optimizedQueue._size;
+
+		EmitOptimizedCommand(encoded);
+		bound.LastDraw = offset;
+		break;
+	}
+
+	case RenderCommandType::MultiDraw:
+	{
+		FlushClears();
+		EmitOptimizedCommand(encoded);
+		break;
+	}
+
+	case RenderCommandType::SetLayer:
+	{
+		break;
+	}
+
+	case RenderCommandType::ExecuteCommandList:
+	{
+		auto commands = command.Data.ExecuteCommandList.Commands;
+
+		for (auto listCommand = commands->Begin(); listCommand != commands->End(); listCommand = CommandList::Next(listCommand))
+			OptimizeCommand(listCommand);
+
+		break;
+	}
+
+	case RenderCommandType::ExecuteCommandBundle:
+	{
+		auto& bundle = *command.Data.ExecuteCommandBundle.Bundle;
+		const CommandList& commands = bundle;
+
+		if (ValidateBundle(bundle))
+		{
+			for (auto bundleCommand = commands.Begin(); bundleCommand != commands.End(); bundleCommand = CommandList::Next(bundleCommand))
+				OptimizeCommand(bundleCommand);
+		}
+
+		break;
+	}
 	}
+}
+
+void GraphicsDevice::EmitOptimizedCommand(EncodedCommand command)
+{
+	_optimizedQueue.Append(command);
+	_boundState.LastDraw = -1;
+}
+
+void GraphicsDevice::FlushClears()
+{
+	if (_boundState.ColorClear != nullptr)
+		EmitOptimizedCommand(_boundState.ColorClear);
+
+	if (_boundState.DepthStencilClear != nullptr)
+		EmitOptimizedCommand(_boundState.DepthStencilClear);
+
+	_boundState.ColorClear = nullptr;
+	_boundState.DepthStencilClear = nullptr;
+}
+
+auto GraphicsDevice::IsBound(EncodedCommand bound, EncodedCommand command) const -> bool
+{
+	return bound != nullptr && CommandList::IsSame(bound, command);
+}
+
+namespace
+{
+	auto GetPrimitiveSize(GeometryTopology topology) -> int
+	{
+		switch (topology)
+		{
+		case GeometryTopology::PointList: return 1;
+		case GeometryTopology::LineList: return 2;
+		case GeometryTopology::TriangleList: return 3;
+		}
+
+		return 0;
+	}
+}
+
+auto GraphicsDevice::CanMergeDraws(const RenderCommand::Draw& previous, const RenderCommand::Draw& next) -> bool
+{
+	if (previous.Count == DrawAll || next.Count == DrawAll || previous.Start + previous.Count != next.Start)
+		return false;
+
+	if (_boundState.InstanceBuffer != nullptr)
+	{
+		auto instances = GetGeometry(CommandList::Read(_boundState.InstanceBuffer).Data.SetInstanceBuffer.Geometry);
+
+		if (instances != nullptr && instances->_uploadedSize > 0 && CommandList::Read(_boundState.InstanceBuffer).Data.SetInstanceBuffer.InstanceSize > 0)
+			return true;
+	}
+
+	if (_boundState.VertexBuffer == nullptr)
+		return false;
+
+	auto vertices = GetGeometry(CommandList::Read(_boundState.VertexBuffer).Data.SetVertexBuffer.Geometry);
+	auto primitiveSize = vertices == nullptr ? 0 : GetPrimitiveSize(vertices->Topology());
+
+	return primitiveSize > 0 && previous.Count % primitiveSize == 0;
+}
+
+void GraphicsDevice::TranslateCommands(const CommandList& commands)
+{
+	for (auto encoded = commands.Begin(); encoded != commands.End(); encoded = CommandList::Next(encoded))
+	{
+		auto command = CommandList::Read(encoded);
+
+		if (command.Type != RenderCommandType::ExecuteCommandList && command.Type != RenderCommandType::ExecuteCommandBundle)
+			_frameStatistics.ExecutedCommands++;
+
+		switch (command.Type)
+		{
+		case RenderCommandType::SetColorTarget: TranslateCommand(command.Data.SetColorTarget); break;
+		case RenderCommandType::ClearColorTarget: TranslateCommand(command.Data.ClearColorTarget); break;
+		case RenderCommandType::SetDepthStencilTarget: TranslateCommand(command.Data.SetDepthStencilTarget); break;
+		case RenderCommandType::ClearDepthStencilTarget: TranslateCommand(command.Data.ClearDepthStencilTarget); break;
+		case RenderCommandType::SetClippingRectangle: TranslateCommand(command.Data.SetClippingRectangle); break;
+		case RenderCommandType::SetMaterial: TranslateCommand(command.Data.SetMaterial); break;
+		case RenderCommandType::SetTexture: TranslateCommand(command.Data.SetTexture); break;
+		case RenderCommandType::SetVertexBuffer: TranslateCommand(command.Data.SetVertexBuffer); break;
+		case RenderCommandType::SetVertexStream: TranslateCommand(command.Data.SetVertexStream); break;
+		case RenderCommandType::SetInstanceBuffer: TranslateCommand(command.Data.SetInstanceBuffer); break;
+		case RenderCommandType::SetIndexBuffer: TranslateCommand(command.Data.SetIndexBuffer); break;
+		case RenderCommandType::SetConstantBuffer: TranslateCommand(command.Data.SetConstantBuffer); break;
+		case RenderCommandType::Draw: TranslateCommand(command.Data.Draw); break;
+		case RenderCommandType::MultiDraw: TranslateCommand(command.Data.MultiDraw); break;
+		case RenderCommandType::SetLayer: break;
+		case RenderCommandType::ExecuteCommandList: TranslateCommands(*command.Data.ExecuteCommandList.Commands); break;
+
+		case RenderCommandType::ExecuteCommandBundle:
+		{
+			auto& bundle = *command.Data.ExecuteCommandBundle.Bundle;
+
+			if (ValidateBundle(bundle))
+				TranslateCommands(bundle);
+			else
+				_frameStatistics.InvalidBundles++;
+
+			break;
+		}
+		}
+	}
+}
+
+auto GraphicsDevice::ValidateBundle(const CommandBundle& bundle) -> bool
+{
+	auto revision = _resourceRevision.load();
+
+	if (bundle._validatedRevision == revision || !bundle._isValid)
+		return bundle._isValid;
+
+	const CommandList& commands = bundle;
+
+	auto recording = bundle._validatedRevision == 0;
+	auto geometryIndex = 0;
+	auto valid = true;
+
+	auto validateTexture = [this](TextureId texture)
+	{
+		return !texture.IsAssigned() || GetTexture(texture) != nullptr;
+	};
+
+	auto validateGeometry = [&](GeometryId id)
+	{
+		auto geometry = GetGeometry(id);
+
+		if (geometry == nullptr)
+			return false;
+
+		if (recording)
+		{
+			bundle._topologies.Add(geometry->Topology());
+			return true;
+		}
+
+		return geometryIndex < bundle._topologies.Count() && bundle._topologies.Item(geometryIndex++) == geometry->Topology();
+	};
+
+	for (auto encoded = commands.Begin(); valid && encoded != commands.End(); encoded = CommandList::Next(encoded))
+	{
+		auto command = CommandList::Read(encoded);
+
+		switch (command.Type)
+		{
+		case RenderCommandType::SetColorTarget: valid = validateTexture(command.Data.SetColorTarget.Texture); break;
+		case RenderCommandType::SetDepthStencilTarget: valid = validateTexture(command.Data.SetDepthStencilTarget.Texture); break;
+		case RenderCommandType::SetTexture: valid = validateTexture(command.Data.SetTexture.Texture); break;
+		case RenderCommandType::SetMaterial: valid = GetMaterial(command.Data.SetMaterial.Material) != nullptr; break;
+		case RenderCommandType::SetVertexBuffer: valid = validateGeometry(command.Data.SetVertexBuffer.Geometry); break;
+		case RenderCommandType::SetVertexStream: valid = validateGeometry(command.Data.SetVertexStream.Geometry); break;
+		case RenderCommandType::SetInstanceBuffer: valid = validateGeometry(command.Data.SetInstanceBuffer.Geometry); break;
+		case RenderCommandType::SetIndexBuffer: valid = validateGeometry(command.Data.SetIndexBuffer.Geometry); break;
+		case RenderCommandType::SetConstantBuffer: valid = validateGeometry(command.Data.SetConstantBuffer.Geometry); break;
+		default: break;
+		}
+	}
+
+	bundle._isValid = valid;
+	bundle._validatedRevision = revision;
+
+	return valid;
+}
+
+template<typename ResourceType>
+auto GraphicsDevice::GetHandle(ResourceType* resource) -> GraphicsHandle<ResourceType>*
+{
+	return resource == nullptr ? nullptr : static_cast<GraphicsHandle<ResourceType>*>(resource->_handle.get());
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetColorTarget& command)
+{
+	auto texture = GetTexture(command.Texture);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetRenderTarget;
+	packet.Data.SetTarget.Texture = texture;
+	packet.Data.SetTarget.Handle = GetHandle(texture);
+	packet.Data.SetTarget.Slot = command.Slot;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::ClearColorTarget& command)
+{
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::ClearColorTarget;
+	packet.Data.ClearColorTarget.R = command.R;
+	packet.Data.ClearColorTarget.G = command.G;
+	packet.Data.ClearColorTarget.B = command.B;
+	packet.Data.ClearColorTarget.A = command.A;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetDepthStencilTarget& command)
+{
+	auto texture = GetTexture(command.Texture);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetDepthStencilTarget;
+	packet.Data.SetTarget.Texture = texture;
+	packet.Data.SetTarget.Handle = GetHandle(texture);
+	packet.Data.SetTarget.Slot = 0;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::ClearDepthStencilTarget& command)
+{
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::ClearDepthAndStencilTarget;
+	packet.Data.ClearDepthAndStencilTarget.Depth = command.DepthValue;
+	packet.Data.ClearDepthAndStencilTarget.Stencil = command.StencilValue;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetClippingRectangle& command)
+{
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetClippingRectangle;
+	packet.Data.SetClippingRectangle.X = command.X;
+	packet.Data.SetClippingRectangle.Y = command.Y;
+	packet.Data.SetClippingRectangle.Width = command.Width;
+	packet.Data.SetClippingRectangle.Height = command.Height;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetMaterial& command)
+{
+	auto material = GetMaterial(command.Material);
+
+	_instanceSize = material == nullptr ? 0 : material->GetInstanceSize();
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetMaterial;
+	packet.Data.SetMaterial.Material = material;
+	packet.Data.SetMaterial.Handle = GetHandle(material);
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetTexture& command)
+{
+	auto texture = GetTexture(command.Texture);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetTexture;
+	packet.Data.SetTarget.Texture = texture;
+	packet.Data.SetTarget.Handle = GetHandle(texture);
+	packet.Data.SetTarget.Slot = command.Slot;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetVertexBuffer& command)
+{
+	auto geometry = GetGeometry(command.Geometry);
+	auto size = command.VertexSize;
+
+	_vertexCount = geometry == nullptr || size == 0 ? 0 : static_cast<int>(geometry->_uploadedSize / size);
+	_indexCount = 0;
+	_instanceCount = 0;
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetVertexBuffer;
+	packet.Data.SetBuffer.Geometry = geometry;
+	packet.Data.SetBuffer.Handle = GetHandle(geometry);
+	packet.Data.SetBuffer.ElementSize = size;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetVertexStream& command)
+{
+	auto geometry = GetGeometry(command.Geometry);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetVertexStream;
+	packet.Data.SetStream.Geometry = geometry;
+	packet.Data.SetStream.Handle = GetHandle(geometry);
+	packet.Data.SetStream.ElementSize = command.VertexSize;
+	packet.Data.SetStream.Stream = command.Stream;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetInstanceBuffer& command)
+{
+	auto geometry = GetGeometry(command.Geometry);
+	auto size = command.InstanceSize;
+
+	_instanceCount = geometry == nullptr || size == 0 ? 0 : static_cast<int>(geometry->_uploadedSize / size);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetInstanceBuffer;
+	packet.Data.SetBuffer.Geometry = geometry;
+	packet.Data.SetBuffer.Handle = GetHandle(geometry);
+	packet.Data.SetBuffer.ElementSize = size;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetIndexBuffer& command)
+{
+	auto geometry = GetGeometry(command.Geometry);
+	auto size = command.IndexSize;
+
+	_indexCount = geometry == nullptr || size == 0 ? 0 : static_cast<int>(geometry->_uploadedSize / size);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetIndexBuffer;
+	packet.Data.SetBuffer.Geometry = geometry;
+	packet.Data.SetBuffer.Handle = GetHandle(geometry);
+	packet.Data.SetBuffer.ElementSize = size;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::SetConstantBuffer& command)
+{
+	if (command.Slot == _instancingSlot)
+	{
+		_instanceConstants = command;
+		_hasInstanceConstants = true;
+		_instanceConstantsPending = true;
+	}
+	else
+	{
+		EmitConstantBuffer(command);
+	}
+}
+
+void GraphicsDevice::EmitConstantBuffer(const RenderCommand::SetConstantBuffer& command)
+{
+	auto geometry = GetGeometry(command.Geometry);
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::SetConstantBuffer;
+	packet.Data.SetConstantBuffer.Geometry = geometry;
+	packet.Data.SetConstantBuffer.Handle = GetHandle(geometry);
+	packet.Data.SetConstantBuffer.Offset = command.Start;
+	packet.Data.SetConstantBuffer.Size = command.Size;
+	packet.Data.SetConstantBuffer.Slot = command.Slot;
+	packet.Data.SetConstantBuffer.VertexAccess = command.VertexAccess;
+	packet.Data.SetConstantBuffer.FragmentAccess = command.FragmentAccess;
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::Draw& command)
+{
+	if (TranslateInstancedDraw(command))
+		return;
+
+	if (_instancingSlot != InstancingDisabled && _instanceCount == 0 && _instanceSize > 0)
+	{
+		_frameStatistics.SkippedDraws++;
+		return;
+	}
+
+	FlushInstanceConstants();
+
+	auto& packet = _renderPackets.Increment();
+
+	if (_instanceCount > 0)
+	{
+		packet.Type = _indexCount > 0 ? RenderPacketType::DrawIndexedInstances : RenderPacketType::DrawInstances;
+		packet.Data.Draw.First = 0;
+		packet.Data.Draw.Count = _indexCount > 0 ? _indexCount : _vertexCount;
+		packet.Data.Draw.FirstInstance = command.Start;
+		packet.Data.Draw.InstanceCount = command.Count == 0 ? _instanceCount : command.Count;
+	}
+	else
+	{
+		packet.Type = _indexCount > 0 ? RenderPacketType::DrawIndices : RenderPacketType::DrawVertices;
+		packet.Data.Draw.First = command.Start;
+		packet.Data.Draw.Count = command.Count == 0 ? (_indexCount > 0 ? _indexCount : _vertexCount) : command.Count;
+		packet.Data.Draw.FirstInstance = 0;
+		packet.Data.Draw.InstanceCount = 1;
+	}
+}
+
+void GraphicsDevice::TranslateCommand(const RenderCommand::MultiDraw& command)
+{
+	FlushInstanceConstants();
+
+	for (auto i = 0; i < command.Count; i++)
+		_drawRanges.Add(CommandList::GetDrawRange(command, i));
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = RenderPacketType::MultiDraw;
+	packet.Data.MultiDraw.Ranges = nullptr;
+	packet.Data.MultiDraw.Count = command.Count;
+	packet.Data.MultiDraw.Indexed = _indexCount > 0;
+}
+
+void GraphicsDevice::ResolveDrawRanges()
+{
+	auto ranges = _drawRanges.begin();
+
+	if (ranges == _drawRanges.end())
+		return;
+
+	for (auto& packet : _renderPackets)
+	{
+		if (packet.Type == RenderPacketType::MultiDraw)
+		{
+			packet.Data.MultiDraw.Ranges = ranges;
+			ranges += packet.Data.MultiDraw.Count;
+		}
+	}
+}
+
+void GraphicsDevice::CaptureInstanceConstants(const CommandList& commands, Frame& frame)
+{
+	for (auto encoded = commands.Begin(); encoded != commands.End(); encoded = CommandList::Next(encoded))
+	{
+		auto type = CommandList::GetType(encoded);
+
+		if (type == RenderCommandType::ExecuteCommandList)
+		{
+			CaptureInstanceConstants(*CommandList::Read(encoded).Data.ExecuteCommandList.Commands, frame);
+		}
+		else if (type == RenderCommandType::ExecuteCommandBundle)
+		{
+			CaptureInstanceConstants(*CommandList::Read(encoded).Data.ExecuteCommandBundle.Bundle, frame);
+		}
+		else if (type == RenderCommandType::SetConstantBuffer)
+		{
+			auto command = CommandList::Read(encoded).Data.SetConstantBuffer;
+
+			if (command.Slot != frame.AutomaticInstancing)
+				continue;
+
+			if (!frame.InstanceConstants.IsEmpty())
+			{
+				auto& previous = frame.InstanceConstants.Last();
+
+				if (previous.Geometry == command.Geometry && previous.Start == command.Start && previous.Size == command.Size)
+					continue;
+			}
+
+			auto geometry = GetGeometry(command.Geometry);
+			auto location = static_cast<std::size_t>(command.Start) * Geometry::_constantDataOffset;
+
+			if (geometry == nullptr || location + command.Size > static_cast<std::size_t>(geometry->Data().Size()))
+				continue;
+
+			auto size = static_cast<int>(command.Size);
+
+			if (frame.InstanceDataSize + size > frame.InstanceData.Size())
+				frame.InstanceData.SetSize(std::max(frame.InstanceDataSize + size, frame.InstanceData.Size() * 2));
+
+			auto data = geometry->Data().begin() + location;
+
+			std::copy(data, data + size, frame.InstanceData.begin() + frame.InstanceDataSize);
+			frame.InstanceConstants.Add({ command.Geometry, command.Start, command.Size, frame.InstanceDataSize });
+			frame.InstanceDataSize += size;
+		}
+	}
+}
+
+void GraphicsDevice::ResetInstancing(const Frame& frame)
+{
+	_instancingSlot = frame.AutomaticInstancing;
+	_instancingFrame = std::addressof(frame);
+	_instanceSize = 0;
+	_hasInstanceConstants = false;
+	_instanceConstantsPending = false;
+	_instancedDraw = -1;
+
+	if (_instancingSlot != InstancingDisabled)
+	{
+		if (_instanceGeometry == nullptr)
+			_instanceGeometry.reset(new Geometry(*this, GraphicsStorage::StreamedToGpu, _renderer->CreateGeometryHandle(), GeometryId{}));
+
+		_instanceGeometry->Reset(GeometryTopology::InstanceData, 0);
+	}
+}
+
+auto GraphicsDevice::FindInstanceConstants(const RenderCommand::SetConstantBuffer& command) const -> const std::uint8_t*
+{
+	auto& captured = _instancingFrame->InstanceConstants;
+	auto key = CapturedConstants{ command.Geometry, command.Start, command.Size, 0 };
+	auto constants = std::lower_bound(captured.begin(), captured.end(), key, IsCapturedBefore<CapturedConstants>);
+
+	if (constants == captured.end() || IsCapturedBefore(key, *constants))
+		return nullptr;
+
+	return _instancingFrame->InstanceData.begin() + constants->Offset;
+}
+
+auto GraphicsDevice::TranslateInstancedDraw(const RenderCommand::Draw& command) -> bool
+{
+	if (_instancingSlot == InstancingDisabled || _instanceCount > 0 || _instanceSize == 0 || !_hasInstanceConstants || _instanceConstants.Size != _instanceSize)
+		return false;
+
+	auto data = FindInstanceConstants(_instanceConstants);
+
+	if (data == nullptr)
+		return false;
+
+	auto indexed = _indexCount > 0;
+	auto type = indexed ? RenderPacketType::DrawIndexedInstances : RenderPacketType::DrawInstances;
+	auto count = command.Count == DrawAll ? (indexed ? _indexCount : _vertexCount) : command.Count;
+	auto instance = _instanceGeometry->Reserve(_instanceSize, 1);
+
+	std::copy(data, data + _instanceSize, instance.Buffer.begin());
+
+	if (_instancedDraw != -1 && _instancedDraw == _renderPackets.Count() - 1)
+	{
+		auto& previous = _renderPackets.Item(_instancedDraw);
+
+		if (previous.Type == type && previous.Data.Draw.First == command.Start && previous.Data.Draw.Count == count && previous.Data.Draw.FirstInstance + previous.Data.Draw.InstanceCount == instance.Offset)
+		{
+			previous.Data.Draw.InstanceCount++;
+			_frameStatistics.InstancedDraws++;
+			return true;
+		}
+	}
+
+	auto& buffer = _renderPackets.Increment();
+	buffer.Type = RenderPacketType::SetInstanceBuffer;
+	buffer.Data.SetBuffer.Geometry = _instanceGeometry.get();
+	buffer.Data.SetBuffer.Handle = GetHandle(_instanceGeometry.get());
+	buffer.Data.SetBuffer.ElementSize = _instanceSize;
+
+	auto& packet = _renderPackets.Increment();
+	packet.Type = type;
+	packet.Data.Draw.First = command.Start;
+	packet.Data.Draw.Count = count;
+	packet.Data.Draw.FirstInstance = instance.Offset;
+	packet.Data.Draw.InstanceCount = 1;
+
+	_instancedDraw = _renderPackets.Count() - 1;
+	return true;
+}
+
+void GraphicsDevice::FlushInstanceConstants()
+{
+	if (_instanceConstantsPending)
+	{
+		EmitConstantBuffer(_instanceConstants);
+		_instanceConstantsPending = false;
+	}
+}
+
+void GraphicsDevice::UploadInstances()
+{
+	if (_instancingSlot != InstancingDisabled && _instanceGeometry->Size() > 0)
+		_instanceGeometry->_handle->Update(_instanceGeometry.get());
 }
\ No newline at end of file
@@ -3,43 +3,297 @@
 #include "Pargon/Serialization/StringReader.h"
 #include "Pargon/Serialization/StringWriter.h"
 
+#include <cstring>
+#include <thread>
+
 using namespace Pargon;
 
 void GraphicsResource_::Lock()
 {
-	assert(!_isLocked);
+	auto state = _state.load(std::memory_order_relaxed);
+	auto readingState = _snapshot ? _publishingState : _uploadingState;
+
+	do
+	{
+		assert((state & _lockedState) == 0);
 
-	std::lock_guard<std::mutex> lock(_graphics._resourceGuard);
-	_isLocked = true;
+		while ((state & readingState) != 0)
+		{
+			std::this_thread::yield();
+			state = _state.load(std::memory_order_relaxed);
+		}
+	}
+	while (!_state.compare_exchange_weak(state, state | _lockedState, std::memory_order_acquire, std::memory_order_relaxed));
 }
 
 void GraphicsResource_::Unlock()
 {
-	assert(_isLocked);
+	auto state = _state.load(std::memory_order_relaxed);
+
+	_contentHash = _graphics._uploadElision.load(std::memory_order_relaxed) ? HashContents() : 0;
+
+	if (_contentHash != 0 && _contentHash == _uploadedHash.load(std::memory_order_relaxed) && (state & (_changedState | _staleState)) == 0)
+	{
+		ClearChanges();
 
-	std::lock_guard<std::mutex> lock(_graphics._resourceGuard);
-	_isLocked = false;
+		_graphics._skippedUploadBytes.fetch_add(ContentSize(), std::memory_order_relaxed);
+		_state.fetch_and(~_lockedState, std::memory_order_release);
+		return;
+	}
 
-	if (!_isChanged)
+	if (_snapshot)
 	{
-		_isChanged = true;
-		_graphics._pendingUpdates.Add(this);
+		Publish(true);
+		return;
 	}
+
+	auto next = state;
+
+	do
+	{
+		assert((state & _lockedState) != 0);
+		next = (state & _retiredState) != 0 ? state & ~_lockedState : (state & ~_lockedState) | _changedState;
+	}
+	while (!_state.compare_exchange_weak(state, next, std::memory_order_release, std::memory_order_relaxed));
+
+	if ((state & _changedState) == 0 && (next & _changedState) != 0)
+		_graphics.QueueUpdate(this);
 }
 
 GraphicsResource_::GraphicsResource_(GraphicsDevice& graphics, GraphicsStorage storage, std::unique_ptr<GraphicsHandle_>&& handle) :
 	_graphics(graphics),
 	_storage(storage),
 	_handle(std::move(handle)),
-	_isLocked(true),
-	_isChanged(false)
+	_state(_lockedState)
 {
 }
 
+void GraphicsResource_::SetDoubleBuffered(bool enabled)
+{
+	assert(IsLocked());
+	assert(!IsChanged());
+	assert(_storage != GraphicsStorage::MappedToGpu && _storage != GraphicsStorage::FrameTransient);
+
+	if (!enabled)
+	{
+		_snapshot.reset();
+	}
+	else if (!_snapshot)
+	{
+		_snapshot = CreateSnapshot();
+		assert(_snapshot);
+	}
+}
+
+void GraphicsResource_::InvalidateCommandBundles()
+{
+	_graphics._resourceRevision++;
+}
+
 void GraphicsResource_::UpdateComplete()
 {
-	if (_storage == GraphicsStorage::TransferredToGpu)
-		Clear();
+	auto source = UploadSource();
+
+	if (_storage == GraphicsStorage::TransferredToGpu || _storage == GraphicsStorage::MappedToGpu)
+		source->Clear();
+
+	source->ClearChanges();
+
+	_uploadedSize = source->ContentSize();
+	_uploadedHash.store(source->_contentHash, std::memory_order_relaxed);
+	_state.fetch_and(~(_changedState | _uploadingState), std::memory_order_release);
+
+	if (_snapshot)
+		Publish(false);
+}
+
+void GraphicsResource_::Recycle()
+{
+	_state.store(_lockedState, std::memory_order_relaxed);
+	_uploadPriority.store(0, std::memory_order_relaxed);
+	_nextUpdate = nullptr;
+	_snapshot.reset();
+	_contentHash = 0;
+	_uploadedHash.store(0, std::memory_order_relaxed);
+	_uploadedSize = 0;
+}
+
+void GraphicsResource_::ClearChanges()
+{
+}
+
+auto GraphicsResource_::HashContents() const -> std::uint64_t
+{
+	return 0;
+}
+
+auto GraphicsResource_::ContentSize() const -> std::size_t
+{
+	return 0;
+}
+
+auto GraphicsResource_::CreateSnapshot() const -> std::unique_ptr<GraphicsResource_>
+{
+	return nullptr;
+}
+
+void GraphicsResource_::CopyContents(GraphicsResource_& snapshot, bool pending) const
+{
+}
+
+namespace
+{
+	constexpr std::uint64_t HashPrime1 = 11400714785074694791ULL;
+	constexpr std::uint64_t HashPrime2 = 14029467366897019727ULL;
+	constexpr std::uint64_t HashPrime3 = 1609587929392839161ULL;
+	constexpr std::uint64_t HashPrime4 = 9650029242287828579ULL;
+	constexpr std::uint64_t HashPrime5 = 2870177450012600261ULL;
+
+	auto RotateLeft(std::uint64_t value, int bits) -> std::uint64_t
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	template<typename ValueType>
+	auto ReadLane(const std::uint8_t* data) -> ValueType
+	{
+		ValueType value;
+		std::memcpy(std::addressof(value), data, sizeof(ValueType));
+		return value;
+	}
+
+	auto HashRound(std::uint64_t accumulator, std::uint64_t lane) -> std::uint64_t
+	{
+		accumulator += lane * HashPrime2;
+		accumulator = RotateLeft(accumulator, 31);
+		return accumulator * HashPrime1;
+	}
+
+	auto MergeRound(std::uint64_t hash, std::uint64_t lane) -> std::uint64_t
+	{
+		hash ^= HashRound(0, lane);
+		return hash * HashPrime1 + HashPrime4;
+	}
+}
+
+auto GraphicsResource_::HashBytes(BufferView bytes, std::uint64_t seed) -> std::uint64_t
+{
+	auto data = bytes.begin();
+	auto end = bytes.end();
+	auto hash = seed + HashPrime5;
+
+	if (bytes.Size() >= 32)
+	{
+		auto first = seed + HashPrime1 + HashPrime2;
+		auto second = seed + HashPrime2;
+		auto third = seed;
+		auto fourth = seed - HashPrime1;
+
+		for (; end - data >= 32; data += 32)
+		{
+			first = HashRound(first, ReadLane<std::uint64_t>(data));
+			second = HashRound(second, ReadLane<std::uint64_t>(data + 8));
+			third = HashRound(third, ReadLane<std::uint64_t>(data + 16));
+			fourth = HashRound(fourth, ReadLane<std::uint64_t>(data + 24));
+		}
+
+		hash = RotateLeft(first, 1) + RotateLeft(second, 7) + RotateLeft(third, 12) + RotateLeft(fourth, 18);
+		hash = MergeRound(hash, first);
+		hash = MergeRound(hash, second);
+		hash = MergeRound(hash, third);
+		hash = MergeRound(hash, fourth);
+	}
+
+	hash += static_cast<std::uint64_t>(bytes.Size());
+
+	for (; end - data >= 8; data += 8)
+	{
+		hash ^= HashRound(0, ReadLane<std::uint64_t>(data));
+		hash = RotateLeft(hash, 27) * HashPrime1 + HashPrime4;
+	}
+
+	if (end - data >= 4)
+	{
+		hash ^= ReadLane<std::uint32_t>(data) * HashPrime1;
+		hash = RotateLeft(hash, 23) * HashPrime2 + HashPrime3;
+		data += 4;
+	}
+
+	for (; data != end; data++)
+	{
+		hash ^= *data * HashPrime5;
+		hash = RotateLeft(hash, 11) * HashPrime1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= HashPrime2;
+	hash ^= hash >> 29;
+	hash *= HashPrime3;
+	hash ^= hash >> 32;
 
-	_isChanged = false;
+	return hash == 0 ? 1 : hash;
 }
+
+auto GraphicsResource_::BeginUpdate() -> bool
+{
+	if (!_snapshot)
+	{
+		auto state = _changedState;
+		return _state.compare_exchange_strong(state, _changedState | _uploadingState, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	auto state = _state.load(std::memory_order_relaxed);
+
+	do
+	{
+		if ((state & (_changedState | _uploadingState | _publishingState | _retiredState)) != _changedState)
+			return false;
+	}
+	while (!_state.compare_exchange_weak(state, state | _uploadingState, std::memory_order_acquire, std::memory_order_relaxed));
+
+	return true;
+}
+
+
+auto GraphicsResource_::IsRetired() const -> bool
+{
+	return (_state.load(std::memory_order_acquire) & _retiredState) != 0;
+}
+
+void GraphicsResource_::Retire()
+{
+	auto state = _state.fetch_or(_retiredState, std::memory_order_acq_rel);
+	assert((state & _retiredState) == 0);
+}
+
+void GraphicsResource_::Publish(bool writer)
+{
+	auto state = _state.load(std::memory_order_relaxed);
+	auto next = state;
+
+	do
+	{
+		if (writer && (state & _retiredState) != 0)
+			next = state & ~_lockedState;
+		else if (writer && (state & _uploadingState) != 0)
+			next = (state & ~_lockedState) | _staleState;
+		else if (writer || (state & (_lockedState | _publishingState | _staleState | _retiredState)) == _staleState)
+			next = (state & ~(_lockedState | _staleState)) | _publishingState;
+		else
+			return;
+	}
+	while (!_state.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+	if ((next & _publishingState) == 0)
+		return;
+
+	CopyContents(*_snapshot, (state & _changedState) != 0);
+	_snapshot->_contentHash = _contentHash;
+	ClearChanges();
+
+	state = _state.fetch_or(_changedState, std::memory_order_relaxed);
+	_state.fetch_and(~_publishingState, std::memory_order_release);
+
+	if ((state & _changedState) == 0)
+		_graphics.QueueUpdate(this);
+}
\ No newline at end of file
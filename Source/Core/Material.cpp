@@ -8,26 +8,6 @@
 
 using namespace Pargon;
 
-auto ShaderElement::Size() const -> size_t
-{
-	switch (Type)
-	{
-	case ShaderElementType::Color: return sizeof(char) * 4;
-	case ShaderElementType::Float: return sizeof(float);
-	case ShaderElementType::Int: return sizeof(int);
-	case ShaderElementType::Matrix3x3: return sizeof(float) * 9;
-	case ShaderElementType::Matrix4x4: return sizeof(float) * 16;
-	case ShaderElementType::Point2: return sizeof(int) * 2;
-	case ShaderElementType::Point3: return sizeof(int) * 3;
-	case ShaderElementType::Point4: return sizeof(int) * 4;
-	case ShaderElementType::Vector2: return sizeof(float) * 2;
-	case ShaderElementType::Vector3: return sizeof(float) * 3;
-	case ShaderElementType::Vector4: return sizeof(float) * 4;
-	}
-
-	return 0;
-}
-
 void Pargon::ToString(ShaderElement element, StringWriter& writer)
 {
 	//writer.Format("{} {} {}", element.Type, element.Usage, element.Index);
@@ -305,24 +285,66 @@ void ShaderCompilationResult::WriteResult(Log& log)
 	}
 }
 
-auto Material::GetVertexSize() const -> std::size_t
+namespace
 {
-	auto size = std::size_t{ 0 };
+	auto GetLayoutSize(const List<ShaderElement>& layout) -> std::size_t
+	{
+		auto size = std::size_t{ 0 };
 
-	for (auto& element : VertexLayout)
-		size += element.Size();
+		for (auto& element : layout)
+			size += element.Size();
 
-	return size;
+		return size;
+	}
+
+	auto GetStreamSize(const List<ShaderElement>& layout, int stream) -> std::size_t
+	{
+		auto size = std::size_t{ 0 };
+
+		for (auto& element : layout)
+		{
+			if (element.Stream == stream)
+				size += element.Size();
+		}
+
+		return size;
+	}
+}
+
+auto Material::GetVertexSize() const -> std::size_t
+{
+	return GetVertexSize(0);
+}
+
+auto Material::GetVertexSize(int stream) const -> std::size_t
+{
+	assert(stream >= 0 && stream < MaximumVertexStreams);
+	return stream == 0 ? _vertexSize : GetStreamSize(_vertexLayout, stream);
 }
 
 auto Material::GetInstanceSize() const -> std::size_t
 {
-	auto size = std::size_t{ 0 };
+	return _instanceSize;
+}
+
+void Material::SetVertexLayout(SequenceView<ShaderElement> layout)
+{
+	_vertexLayout.Clear();
+
+	for (auto& element : layout)
+		_vertexLayout.Add(element);
+
+	_vertexSize = GetStreamSize(_vertexLayout, 0);
+}
+
+void Material::SetInstanceLayout(SequenceView<ShaderElement> layout)
+{
+	_instanceLayout.Clear();
 
-	for (auto& element : InstanceLayout)
-		size += element.Size();
+	for (auto& element : layout)
+		_instanceLayout.Add(element);
 
-	return size;
+	_instanceSize = GetLayoutSize(_instanceLayout);
 }
 
 void Material::Reset()
@@ -339,9 +361,12 @@ void Material::Reset()
 	StencilOptions = DisabledStenciling;
 	SampleOptions.Clear();
 
-	VertexLayout.Clear();
-	InstanceLayout.Clear();
+	_vertexLayout.Clear();
+	_instanceLayout.Clear();
 	Output.Clear();
+
+	_vertexSize = 0;
+	_instanceSize = 0;
 }
 
 auto Material::Reset(StringView filename) -> ShaderCompilationResult
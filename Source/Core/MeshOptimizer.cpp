@@ -0,0 +1,495 @@
+#include "Pargon/Graphics/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Pargon;
+
+namespace
+{
+	constexpr unsigned int UnusedVertex = ~0u;
+
+	struct Position
+	{
+		float X;
+		float Y;
+		float Z;
+	};
+
+	auto HashVertex(const std::uint8_t* data, std::size_t size) -> unsigned int
+	{
+		auto hash = 2166136261u;
+
+		for (auto i = std::size_t(0); i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+	auto ReadPosition(const Buffer& vertices, unsigned int vertex, std::size_t vertexSize, int positionOffset) -> Position
+	{
+		Position position;
+		std::memcpy(std::addressof(position), vertices.begin() + vertex * vertexSize + positionOffset, sizeof(Position));
+		return position;
+	}
+
+	struct TriangleShape
+	{
+		Position Center;
+		Position Normal;
+		float Area;
+	};
+
+	auto GetTriangleShape(const Buffer& vertices, const List<unsigned int>& indices, int triangle, std::size_t vertexSize, int positionOffset) -> TriangleShape
+	{
+		auto a = ReadPosition(vertices, indices.Item(triangle * 3), vertexSize, positionOffset);
+		auto b = ReadPosition(vertices, indices.Item(triangle * 3 + 1), vertexSize, positionOffset);
+		auto c = ReadPosition(vertices, indices.Item(triangle * 3 + 2), vertexSize, positionOffset);
+
+		auto ab = Position{ b.X - a.X, b.Y - a.Y, b.Z - a.Z };
+		auto ac = Position{ c.X - a.X, c.Y - a.Y, c.Z - a.Z };
+		auto cross = Position{ ab.Y * ac.Z - ab.Z * ac.Y, ab.Z * ac.X - ab.X * ac.Z, ab.X * ac.Y - ab.Y * ac.X };
+		auto length = std::sqrt(cross.X * cross.X + cross.Y * cross.Y + cross.Z * cross.Z);
+		auto scale = length > 0.0f ? 1.0f / length : 0.0f;
+
+		return { { (a.X + b.X + c.X) / 3.0f, (a.Y + b.Y + c.Y) / 3.0f, (a.Z + b.Z + c.Z) / 3.0f }, { cross.X * scale, cross.Y * scale, cross.Z * scale }, length * 0.5f };
+	}
+
+	auto IsCacheMiss(List<unsigned int>& timestamps, unsigned int vertex, unsigned int& time, int cacheSize) -> bool
+	{
+		auto& timestamp = timestamps.Item(vertex);
+
+		if (time - timestamp <= static_cast<unsigned int>(cacheSize))
+			return false;
+
+		timestamp = time++;
+		return true;
+	}
+}
+
+void MeshOptimizer::SetCacheSize(int size)
+{
+	assert(size > 3 && size <= MaximumCacheSize);
+	_cacheSize = size;
+}
+
+void MeshOptimizer::SetOverdrawThreshold(float threshold)
+{
+	assert(threshold >= 1.0f);
+	_overdrawThreshold = threshold;
+}
+
+auto MeshOptimizer::Optimize(Geometry& vertices, Geometry& indices, std::size_t vertexSize, std::size_t indexSize, int positionOffset) -> MeshOptimizationResult
+{
+	assert(vertices.IsLocked() && indices.IsLocked());
+	assert(vertices.Topology() == GeometryTopology::TriangleList);
+	assert(indices.Topology() == GeometryTopology::IndexList);
+	assert(indexSize == 2 || indexSize == 4);
+	assert(positionOffset == NoPosition || positionOffset + sizeof(Position) <= vertexSize);
+
+	Load(vertices, indices, vertexSize, indexSize);
+	WeldVertices(vertexSize);
+	OptimizeVertexCache(static_cast<int>(_vertices.Size() / vertexSize));
+	OptimizeOverdraw(vertexSize, positionOffset);
+	OptimizeVertexFetch(vertexSize);
+
+	auto vertexCount = static_cast<int>(_vertices.Size() / vertexSize);
+	auto triangleCount = _indices.Count() / 3;
+	auto outputIndexSize = vertexCount <= 65536 ? std::size_t(2) : std::size_t(4);
+	auto misses = SimulateCache(vertexCount);
+
+	Store(vertices, indices, vertexSize, outputIndexSize);
+
+	return { vertexCount, _indices.Count(), outputIndexSize, triangleCount == 0 ? 0.0f : static_cast<float>(misses) / triangleCount };
+}
+
+void MeshOptimizer::Load(const Geometry& vertices, const Geometry& indices, std::size_t vertexSize, std::size_t indexSize)
+{
+	auto vertexData = vertices.Data();
+	auto indexData = indices.Data();
+	auto vertexCount = static_cast<int>(vertexData.Size() / vertexSize);
+	auto indexCount = static_cast<int>(indexData.Size() / indexSize);
+
+	_vertices.SetSize(static_cast<int>(vertexCount * vertexSize));
+	std::copy(vertexData.begin(), vertexData.begin() + _vertices.Size(), _vertices.begin());
+
+	_indices.SetCount(indexCount - indexCount % 3);
+
+	for (auto i = 0; i < _indices.Count(); i++)
+	{
+		auto index = 0u;
+
+		if (indexSize == 2)
+		{
+			std::uint16_t shortIndex;
+			std::memcpy(std::addressof(shortIndex), indexData.begin() + i * indexSize, indexSize);
+			index = shortIndex;
+		}
+		else
+		{
+			std::memcpy(std::addressof(index), indexData.begin() + i * indexSize, indexSize);
+		}
+
+		assert(index < static_cast<unsigned int>(vertexCount));
+		_indices.Item(i) = index;
+	}
+}
+
+void MeshOptimizer::Store(Geometry& vertices, Geometry& indices, std::size_t vertexSize, std::size_t indexSize)
+{
+	auto vertexCount = static_cast<int>(_vertices.Size() / vertexSize);
+
+	vertices.Reset(vertices.Topology(), _vertices.Size());
+
+	auto vertexReservation = vertices.Reserve(vertexSize, vertexCount);
+	std::copy(_vertices.begin(), _vertices.end(), vertexReservation.Buffer.begin());
+
+	indices.Reset(GeometryTopology::IndexList, static_cast<int>(_indices.Count() * indexSize));
+
+	auto indexReservation = indices.Reserve(indexSize, _indices.Count());
+
+	for (auto i = 0; i < _indices.Count(); i++)
+	{
+		auto index = _indices.Item(i);
+
+		if (indexSize == 2)
+		{
+			auto shortIndex = static_cast<std::uint16_t>(index);
+			std::memcpy(indexReservation.Buffer.begin() + i * indexSize, std::addressof(shortIndex), indexSize);
+		}
+		else
+		{
+			std::memcpy(indexReservation.Buffer.begin() + i * indexSize, std::addressof(index), indexSize);
+		}
+	}
+}
+
+void MeshOptimizer::WeldVertices(std::size_t vertexSize)
+{
+	auto vertexCount = static_cast<int>(_vertices.Size() / vertexSize);
+	auto tableSize = 1;
+
+	while (tableSize < vertexCount * 2)
+		tableSize <<= 1;
+
+	_table.SetCount(tableSize);
+	_remap.SetCount(vertexCount);
+	_vertexScratch.SetSize(_vertices.Size());
+
+	std::fill(_table.begin(), _table.end(), -1);
+
+	auto unique = 0;
+
+	for (auto vertex = 0; vertex < vertexCount; vertex++)
+	{
+		auto data = _vertices.begin() + vertex * vertexSize;
+		auto slot = static_cast<int>(HashVertex(data, vertexSize) & (tableSize - 1));
+
+		while (_table.Item(slot) != -1 && std::memcmp(_vertexScratch.begin() + _table.Item(slot) * vertexSize, data, vertexSize) != 0)
+			slot = (slot + 1) & (tableSize - 1);
+
+		if (_table.Item(slot) == -1)
+		{
+			_table.Item(slot) = unique;
+			std::copy(data, data + vertexSize, _vertexScratch.begin() + unique * vertexSize);
+			unique++;
+		}
+
+		_remap.Item(vertex) = _table.Item(slot);
+	}
+
+	auto kept = 0;
+
+	for (auto i = 0; i < _indices.Count(); i += 3)
+	{
+		auto first = _remap.Item(_indices.Item(i));
+		auto second = _remap.Item(_indices.Item(i + 1));
+		auto third = _remap.Item(_indices.Item(i + 2));
+
+		if (first == second || second == third || third == first)
+			continue;
+
+		_indices.Item(kept++) = first;
+		_indices.Item(kept++) = second;
+		_indices.Item(kept++) = third;
+	}
+
+	_indices.SetCount(kept);
+	_vertexScratch.SetSize(static_cast<int>(unique * vertexSize));
+	std::swap(_vertices, _vertexScratch);
+}
+
+void MeshOptimizer::OptimizeVertexCache(int vertexCount)
+{
+	auto triangleCount = _indices.Count() / 3;
+
+	_valence.SetCount(vertexCount);
+	_adjacencyOffsets.SetCount(vertexCount + 1);
+	_adjacency.SetCount(_indices.Count());
+	_cachePositions.SetCount(vertexCount);
+	_vertexScores.SetCount(vertexCount);
+	_emitted.SetCount(triangleCount);
+	_indexScratch.Clear();
+	_cache.Clear();
+
+	std::fill(_valence.begin(), _valence.end(), 0);
+	std::fill(_emitted.begin(), _emitted.end(), std::uint8_t(0));
+
+	for (auto index : _indices)
+		_valence.Item(index)++;
+
+	_adjacencyOffsets.Item(0) = 0;
+
+	for (auto vertex = 0; vertex < vertexCount; vertex++)
+	{
+		_adjacencyOffsets.Item(vertex + 1) = _adjacencyOffsets.Item(vertex) + _valence.Item(vertex);
+		_cachePositions.Item(vertex) = _adjacencyOffsets.Item(vertex);
+	}
+
+	for (auto i = 0; i < _indices.Count(); i++)
+		_adjacency.Item(_cachePositions.Item(_indices.Item(i))++) = i / 3;
+
+	std::fill(_cachePositions.begin(), _cachePositions.end(), -1);
+
+	for (auto vertex = 0; vertex < vertexCount; vertex++)
+		_vertexScores.Item(vertex) = GetVertexScore(vertex);
+
+	auto best = -1;
+	auto next = 0;
+
+	for (auto emitted = 0; emitted < triangleCount; emitted++)
+	{
+		if (best == -1)
+		{
+			while (_emitted.Item(next) != 0)
+				next++;
+
+			best = next;
+		}
+
+		auto triangle = best;
+		auto first = _indices.Item(triangle * 3);
+		auto second = _indices.Item(triangle * 3 + 1);
+		auto third = _indices.Item(triangle * 3 + 2);
+
+		_emitted.Item(triangle) = 1;
+		_nextCache.Clear();
+
+		for (auto vertex : { first, second, third })
+		{
+			auto start = _adjacencyOffsets.Item(vertex);
+			auto end = start + _valence.Item(vertex);
+
+			std::swap(*std::find(_adjacency.begin() + start, _adjacency.begin() + end, triangle), _adjacency.Item(end - 1));
+
+			_valence.Item(vertex)--;
+			_indexScratch.Add(vertex);
+			_nextCache.Add(vertex);
+		}
+
+		for (auto vertex : _cache)
+		{
+			if (vertex != first && vertex != second && vertex != third)
+				_nextCache.Add(vertex);
+		}
+
+		for (auto i = 0; i < _nextCache.Count(); i++)
+		{
+			auto vertex = _nextCache.Item(i);
+			_cachePositions.Item(vertex) = i < _cacheSize ? i : -1;
+			_vertexScores.Item(vertex) = GetVertexScore(vertex);
+		}
+
+		auto bestScore = 0.0f;
+		best = -1;
+
+		for (auto vertex : _nextCache)
+		{
+			auto start = _adjacencyOffsets.Item(vertex);
+			auto end = start + _valence.Item(vertex);
+
+			for (auto i = start; i < end; i++)
+			{
+				auto candidate = _adjacency.Item(i);
+				auto score = _vertexScores.Item(_indices.Item(candidate * 3)) + _vertexScores.Item(_indices.Item(candidate * 3 + 1)) + _vertexScores.Item(_indices.Item(candidate * 3 + 2));
+
+				if (score > bestScore)
+				{
+					best = candidate;
+					bestScore = score;
+				}
+			}
+		}
+
+		if (_nextCache.Count() > _cacheSize)
+			_nextCache.SetCount(_cacheSize);
+
+		std::swap(_cache, _nextCache);
+	}
+
+	std::swap(_indices, _indexScratch);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::size_t vertexSize, int positionOffset)
+{
+	auto vertexCount = static_cast<int>(_vertices.Size() / vertexSize);
+	auto triangleCount = _indices.Count() / 3;
+
+	if (positionOffset == NoPosition || triangleCount == 0)
+		return;
+
+	auto meshRatio = static_cast<float>(SimulateCache(vertexCount)) / triangleCount;
+	auto time = static_cast<unsigned int>(_cacheSize) + 1;
+	auto clusterMisses = 0;
+
+	_timestamps.SetCount(vertexCount);
+	_clusters.Clear();
+
+	std::fill(_timestamps.begin(), _timestamps.end(), 0u);
+
+	for (auto triangle = 0; triangle < triangleCount; triangle++)
+	{
+		auto misses = 0;
+
+		for (auto i = 0; i < 3; i++)
+		{
+			if (IsCacheMiss(_timestamps, _indices.Item(triangle * 3 + i), time, _cacheSize))
+				misses++;
+		}
+
+		if (_clusters.IsEmpty() || (misses == 3 && static_cast<float>(clusterMisses) / _clusters.Last().Count <= meshRatio * _overdrawThreshold))
+		{
+			_clusters.Add({ triangle, 0, 0.0f });
+			clusterMisses = 0;
+		}
+
+		_clusters.Last().Count++;
+		clusterMisses += misses;
+	}
+
+	auto meshCenter = Position{ 0.0f, 0.0f, 0.0f };
+	auto meshArea = 0.0f;
+
+	for (auto triangle = 0; triangle < triangleCount; triangle++)
+	{
+		auto shape = GetTriangleShape(_vertices, _indices, triangle, vertexSize, positionOffset);
+
+		meshCenter.X += shape.Center.X * shape.Area;
+		meshCenter.Y += shape.Center.Y * shape.Area;
+		meshCenter.Z += shape.Center.Z * shape.Area;
+		meshArea += shape.Area;
+	}
+
+	if (meshArea > 0.0f)
+		meshCenter = { meshCenter.X / meshArea, meshCenter.Y / meshArea, meshCenter.Z / meshArea };
+
+	for (auto& cluster : _clusters)
+	{
+		auto center = Position{ 0.0f, 0.0f, 0.0f };
+		auto normal = Position{ 0.0f, 0.0f, 0.0f };
+		auto area = 0.0f;
+
+		for (auto triangle = cluster.Start; triangle < cluster.Start + cluster.Count; triangle++)
+		{
+			auto shape = GetTriangleShape(_vertices, _indices, triangle, vertexSize, positionOffset);
+
+			center.X += shape.Center.X * shape.Area;
+			center.Y += shape.Center.Y * shape.Area;
+			center.Z += shape.Center.Z * shape.Area;
+			normal.X += shape.Normal.X * shape.Area;
+			normal.Y += shape.Normal.Y * shape.Area;
+			normal.Z += shape.Normal.Z * shape.Area;
+			area += shape.Area;
+		}
+
+		if (area > 0.0f)
+			center = { center.X / area - meshCenter.X, center.Y / area - meshCenter.Y, center.Z / area - meshCenter.Z };
+
+		cluster.Sort = center.X * normal.X + center.Y * normal.Y + center.Z * normal.Z;
+	}
+
+	std::stable_sort(_clusters.begin(), _clusters.end(), [](const Cluster& left, const Cluster& right)
+	{
+		return left.Sort > right.Sort;
+	});
+
+	_indexScratch.Clear();
+
+	for (auto& cluster : _clusters)
+	{
+		for (auto i = cluster.Start * 3; i < (cluster.Start + cluster.Count) * 3; i++)
+			_indexScratch.Add(_indices.Item(i));
+	}
+
+	std::swap(_indices, _indexScratch);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::size_t vertexSize)
+{
+	auto vertexCount = static_cast<int>(_vertices.Size() / vertexSize);
+	auto next = 0u;
+
+	_remap.SetCount(vertexCount);
+
+	std::fill(_remap.begin(), _remap.end(), UnusedVertex);
+
+	for (auto& index : _indices)
+	{
+		auto& remapped = _remap.Item(index);
+
+		if (remapped == UnusedVertex)
+			remapped = next++;
+
+		index = remapped;
+	}
+
+	_vertexScratch.SetSize(static_cast<int>(next * vertexSize));
+
+	for (auto vertex = 0; vertex < vertexCount; vertex++)
+	{
+		auto remapped = _remap.Item(vertex);
+
+		if (remapped != UnusedVertex)
+			std::copy(_vertices.begin() + vertex * vertexSize, _vertices.begin() + (vertex + 1) * vertexSize, _vertexScratch.begin() + remapped * vertexSize);
+	}
+
+	std::swap(_vertices, _vertexScratch);
+}
+
+auto MeshOptimizer::GetVertexScore(int vertex) const -> float
+{
+	auto valence = _valence.Item(vertex);
+	auto position = _cachePositions.Item(vertex);
+
+	if (valence == 0)
+		return -1.0f;
+
+	auto score = 0.0f;
+
+	if (position >= 0)
+		score = position < 3 ? 0.75f : std::pow(1.0f - static_cast<float>(position - 3) / (_cacheSize - 3), 1.5f);
+
+	return score + 2.0f / std::sqrt(static_cast<float>(valence));
+}
+
+auto MeshOptimizer::SimulateCache(int vertexCount) -> int
+{
+	auto time = static_cast<unsigned int>(_cacheSize) + 1;
+	auto misses = 0;
+
+	_timestamps.SetCount(vertexCount);
+
+	std::fill(_timestamps.begin(), _timestamps.end(), 0u);
+
+	for (auto index : _indices)
+	{
+		if (IsCacheMiss(_timestamps, index, time, _cacheSize))
+			misses++;
+	}
+
+	return misses;
+}
\ No newline at end of file
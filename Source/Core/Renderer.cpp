@@ -25,3 +25,33 @@ void RendererInformation::WriteCapabilities(Log& log)
 
 	log.Write(capabilities, SupportedSampleCounts);
 }
+
+
+void Renderer::Execute(SequenceView<RenderPacket> packets)
+{
+	for (auto& packet : packets)
+	{
+		auto& data = packet.Data;
+
+		switch (packet.Type)
+		{
+		case RenderPacketType::SetRenderTarget: SetRenderTarget(data.SetTarget.Texture, data.SetTarget.Slot); break;
+		case RenderPacketType::ClearColorTarget: ClearColorTarget(data.ClearColorTarget.R, data.ClearColorTarget.G, data.ClearColorTarget.B, data.ClearColorTarget.A); break;
+		case RenderPacketType::SetDepthStencilTarget: SetDepthStencilTarget(data.SetTarget.Texture); break;
+		case RenderPacketType::ClearDepthAndStencilTarget: ClearDepthAndStencilTarget(data.ClearDepthAndStencilTarget.Depth, data.ClearDepthAndStencilTarget.Stencil); break;
+		case RenderPacketType::SetClippingRectangle: SetClippingRectangle(data.SetClippingRectangle.X, data.SetClippingRectangle.Y, data.SetClippingRectangle.Width, data.SetClippingRectangle.Height); break;
+		case RenderPacketType::SetMaterial: SetMaterial(data.SetMaterial.Material); break;
+		case RenderPacketType::SetTexture: SetTexture(data.SetTarget.Texture, data.SetTarget.Slot); break;
+		case RenderPacketType::SetVertexBuffer: SetVertexBuffer(data.SetBuffer.Geometry, data.SetBuffer.ElementSize); break;
+		case RenderPacketType::SetVertexStream: SetVertexStream(data.SetStream.Geometry, data.SetStream.ElementSize, data.SetStream.Stream); break;
+		case RenderPacketType::SetInstanceBuffer: SetInstanceBuffer(data.SetBuffer.Geometry, data.SetBuffer.ElementSize); break;
+		case RenderPacketType::SetIndexBuffer: SetIndexBuffer(data.SetBuffer.Geometry, data.SetBuffer.ElementSize); break;
+		case RenderPacketType::SetConstantBuffer: SetConstantBuffer(data.SetConstantBuffer.Geometry, data.SetConstantBuffer.VertexAccess, data.SetConstantBuffer.FragmentAccess, data.SetConstantBuffer.Offset, data.SetConstantBuffer.Size, data.SetConstantBuffer.Slot); break;
+		case RenderPacketType::DrawVertices: DrawVertices(data.Draw.First, data.Draw.Count); break;
+		case RenderPacketType::DrawIndices: DrawIndices(data.Draw.First, data.Draw.Count); break;
+		case RenderPacketType::DrawInstances: DrawInstances(data.Draw.First, data.Draw.Count, data.Draw.FirstInstance, data.Draw.InstanceCount); break;
+		case RenderPacketType::DrawIndexedInstances: DrawIndexedInstances(data.Draw.First, data.Draw.Count, data.Draw.FirstInstance, data.Draw.InstanceCount); break;
+		case RenderPacketType::MultiDraw: MultiDraw({ data.MultiDraw.Ranges, data.MultiDraw.Count }, data.MultiDraw.Indexed); break;
+		}
+	}
+}
@@ -504,3 +504,58 @@ void Texture::Clear()
 {
 	_reservations.Clear();
 }
+
+auto Texture::HashContents() const -> std::uint64_t
+{
+	auto hash = HashBytes({}, (static_cast<std::uint64_t>(_size.Width) << 32) | _size.Height);
+	hash = HashBytes({}, hash ^ static_cast<std::uint64_t>(_format));
+
+	for (auto& reservation : _reservations)
+	{
+		hash = HashBytes({}, hash ^ ((static_cast<std::uint64_t>(reservation.Location.X) << 32) | reservation.Location.Y));
+		hash = HashBytes({}, hash ^ ((static_cast<std::uint64_t>(reservation.Size.Width) << 32) | reservation.Size.Height));
+		hash = HashBytes(reservation.Data, hash ^ reservation.Pitch);
+	}
+
+	return hash;
+}
+
+auto Texture::ContentSize() const -> std::size_t
+{
+	auto size = std::size_t(0);
+
+	for (auto& reservation : _reservations)
+		size += static_cast<std::size_t>(reservation.Data.Size());
+
+	return size;
+}
+
+auto Texture::CreateSnapshot() const -> std::unique_ptr<GraphicsResource_>
+{
+	return std::unique_ptr<Texture>(new Texture(Graphics(), Storage(), nullptr, Id()));
+}
+
+void Texture::CopyContents(GraphicsResource_& snapshot, bool pending) const
+{
+	auto& texture = static_cast<Texture&>(snapshot);
+
+	texture._size = _size;
+	texture._depth = _depth;
+	texture._format = _format;
+	texture._sampleCount = _sampleCount;
+	texture._identifier = _identifier;
+	texture._reservations.SetCount(_reservations.Count());
+
+	for (auto i = 0; i < _reservations.Count(); i++)
+	{
+		auto& source = _reservations.Item(i);
+		auto& target = texture._reservations.Item(i);
+
+		target.Location = source.Location;
+		target.Size = source.Size;
+		target.Pitch = source.Pitch;
+		target.Data.SetSize(source.Data.Size());
+
+		std::copy(source.Data.begin(), source.Data.end(), target.Data.begin());
+	}
+}
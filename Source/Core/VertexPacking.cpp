@@ -0,0 +1,323 @@
+#include "Pargon/Graphics/VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define PARGON_PACKING_SSE2
+	#include <emmintrin.h>
+#endif
+
+using namespace Pargon;
+
+namespace
+{
+	constexpr int BlockSize = 64;
+
+	auto Clamp(float value, float minimum, float maximum) -> float
+	{
+		value = value > minimum ? value : minimum;
+		return value < maximum ? value : maximum;
+	}
+
+	auto Quantize(float value, float minimum, float scale) -> int
+	{
+		return static_cast<int>(std::lrint(Clamp(value, minimum, 1.0f) * scale));
+	}
+
+	struct HalfConversion
+	{
+		static auto Convert(float value) -> std::uint16_t
+		{
+			std::uint32_t bits;
+			std::memcpy(std::addressof(bits), std::addressof(value), sizeof(bits));
+
+			auto sign = bits & 0x80000000u;
+			auto result = 0u;
+
+			bits ^= sign;
+
+			if (bits >= 0x7f800000u)
+			{
+				result = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+			}
+			else
+			{
+				auto magic = 15u << 23;
+				float scaled, factor;
+
+				bits &= ~0xfffu;
+				std::memcpy(std::addressof(scaled), std::addressof(bits), sizeof(bits));
+				std::memcpy(std::addressof(factor), std::addressof(magic), sizeof(magic));
+
+				scaled *= factor;
+				std::memcpy(std::addressof(bits), std::addressof(scaled), sizeof(bits));
+
+				bits += 0x1000u;
+				result = std::min(bits, 31u << 23) >> 13;
+			}
+
+			return static_cast<std::uint16_t>(result | (sign >> 16));
+		}
+
+#ifdef PARGON_PACKING_SSE2
+		static auto Convert(__m128 values) -> __m128i
+		{
+			auto infinity = _mm_set1_epi32(0x7f800000);
+			auto round = _mm_castsi128_ps(_mm_set1_epi32(~0xfff));
+
+			auto sign = _mm_and_ps(values, _mm_castsi128_ps(_mm_set1_epi32(0x80000000u)));
+			auto absolute = _mm_xor_ps(values, sign);
+			auto isNan = _mm_cmpgt_epi32(_mm_castps_si128(absolute), infinity);
+			auto isFinite = _mm_cmpgt_epi32(infinity, _mm_castps_si128(absolute));
+			auto special = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+			auto scaled = _mm_mul_ps(_mm_and_ps(absolute, round), _mm_castsi128_ps(_mm_set1_epi32(15 << 23)));
+			auto clamped = _mm_min_ps(scaled, _mm_castsi128_ps(_mm_set1_epi32((31 << 23) - 0x1000)));
+			auto finite = _mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(clamped), _mm_castps_si128(round)), 13);
+
+			auto result = _mm_or_si128(_mm_and_si128(isFinite, finite), _mm_andnot_si128(isFinite, special));
+			return _mm_or_si128(result, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+		}
+#endif
+	};
+
+	struct SignedNormalConversion
+	{
+		static auto Convert(float value) -> std::uint16_t
+		{
+			return static_cast<std::uint16_t>(Quantize(value, -1.0f, 32767.0f));
+		}
+
+#ifdef PARGON_PACKING_SSE2
+		static auto Convert(__m128 values) -> __m128i
+		{
+			auto clamped = _mm_min_ps(_mm_max_ps(values, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+			return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(32767.0f)));
+		}
+#endif
+	};
+
+	struct UnsignedNormalConversion
+	{
+		static auto Convert(float value) -> std::uint16_t
+		{
+			return static_cast<std::uint16_t>(Quantize(value, 0.0f, 65535.0f));
+		}
+
+#ifdef PARGON_PACKING_SSE2
+		static auto Convert(__m128 values) -> __m128i
+		{
+			auto clamped = _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(65535.0f)));
+		}
+#endif
+	};
+
+	struct PackedConversion
+	{
+		static auto Convert(const float* values) -> std::uint32_t
+		{
+			auto x = static_cast<std::uint32_t>(Quantize(values[0], 0.0f, 1023.0f));
+			auto y = static_cast<std::uint32_t>(Quantize(values[1], 0.0f, 1023.0f));
+			auto z = static_cast<std::uint32_t>(Quantize(values[2], 0.0f, 1023.0f));
+			auto w = static_cast<std::uint32_t>(Quantize(values[3], 0.0f, 3.0f));
+
+			return x | (y << 10) | (z << 20) | (w << 30);
+		}
+
+#ifdef PARGON_PACKING_SSE2
+		static auto Convert(__m128 x, __m128 y, __m128 z, __m128 w) -> __m128i
+		{
+			auto packed = QuantizeUnit(x, 1023.0f);
+			packed = _mm_or_si128(packed, _mm_slli_epi32(QuantizeUnit(y, 1023.0f), 10));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(QuantizeUnit(z, 1023.0f), 20));
+			return _mm_or_si128(packed, _mm_slli_epi32(QuantizeUnit(w, 3.0f), 30));
+		}
+
+		static auto QuantizeUnit(__m128 values, float scale) -> __m128i
+		{
+			auto clamped = _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			return _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(scale)));
+		}
+#endif
+	};
+
+	struct ColorConversion
+	{
+		static auto Convert(const float* values) -> std::uint32_t
+		{
+			auto r = static_cast<std::uint32_t>(Quantize(values[0], 0.0f, 255.0f));
+			auto g = static_cast<std::uint32_t>(Quantize(values[1], 0.0f, 255.0f));
+			auto b = static_cast<std::uint32_t>(Quantize(values[2], 0.0f, 255.0f));
+			auto a = static_cast<std::uint32_t>(Quantize(values[3], 0.0f, 255.0f));
+
+			return r | (g << 8) | (b << 16) | (a << 24);
+		}
+
+#ifdef PARGON_PACKING_SSE2
+		static auto Convert(__m128 r, __m128 g, __m128 b, __m128 a) -> __m128i
+		{
+			auto packed = PackedConversion::QuantizeUnit(r, 255.0f);
+			packed = _mm_or_si128(packed, _mm_slli_epi32(PackedConversion::QuantizeUnit(g, 255.0f), 8));
+			packed = _mm_or_si128(packed, _mm_slli_epi32(PackedConversion::QuantizeUnit(b, 255.0f), 16));
+			return _mm_or_si128(packed, _mm_slli_epi32(PackedConversion::QuantizeUnit(a, 255.0f), 24));
+		}
+#endif
+	};
+
+	template<typename ConversionType>
+	void Convert16(const float* source, int count, std::uint16_t* destination)
+	{
+		auto i = 0;
+
+#ifdef PARGON_PACKING_SSE2
+		for (; i + 8 <= count; i += 8)
+		{
+			auto low = ConversionType::Convert(_mm_loadu_ps(source + i));
+			auto high = ConversionType::Convert(_mm_loadu_ps(source + i + 4));
+
+			low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+			high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packs_epi32(low, high));
+		}
+#endif
+
+		for (; i < count; i++)
+			destination[i] = ConversionType::Convert(source[i]);
+	}
+
+	template<typename ConversionType>
+	void Convert32(const float* source, int count, std::uint32_t* destination)
+	{
+		auto i = 0;
+
+#ifdef PARGON_PACKING_SSE2
+		for (; i + 4 <= count; i += 4)
+		{
+			auto x = _mm_loadu_ps(source + i * 4);
+			auto y = _mm_loadu_ps(source + i * 4 + 4);
+			auto z = _mm_loadu_ps(source + i * 4 + 8);
+			auto w = _mm_loadu_ps(source + i * 4 + 12);
+
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), ConversionType::Convert(x, y, z, w));
+		}
+#endif
+
+		for (; i < count; i++)
+			destination[i] = ConversionType::Convert(source + i * 4);
+	}
+
+	void Scatter(const std::uint8_t* block, int count, std::size_t elementSize, std::uint8_t* destination, std::size_t stride)
+	{
+		if (stride == elementSize)
+		{
+			std::memcpy(destination, block, count * elementSize);
+			return;
+		}
+
+		for (auto i = 0; i < count; i++)
+			std::memcpy(destination + i * stride, block + i * elementSize, elementSize);
+	}
+
+	template<typename ConversionType>
+	void Pack16(SequenceView<float> source, int components, std::uint8_t* destination, std::size_t stride)
+	{
+		std::uint16_t block[BlockSize];
+
+		auto elementCount = source.Count() / components;
+		auto blockCount = BlockSize / components;
+
+		for (auto element = 0; element < elementCount; element += blockCount)
+		{
+			auto count = std::min(blockCount, elementCount - element);
+
+			Convert16<ConversionType>(source.begin() + element * components, count * components, block);
+			Scatter(reinterpret_cast<const std::uint8_t*>(block), count, components * sizeof(std::uint16_t), destination + element * stride, stride);
+		}
+	}
+
+	template<typename ConversionType>
+	void Pack32(SequenceView<float> source, std::uint8_t* destination, std::size_t stride)
+	{
+		std::uint32_t block[BlockSize / 4];
+
+		auto elementCount = source.Count() / 4;
+
+		for (auto element = 0; element < elementCount; element += BlockSize / 4)
+		{
+			auto count = std::min(BlockSize / 4, elementCount - element);
+
+			Convert32<ConversionType>(source.begin() + element * 4, count, block);
+			Scatter(reinterpret_cast<const std::uint8_t*>(block), count, sizeof(std::uint32_t), destination + element * stride, stride);
+		}
+	}
+
+	void PackFloats(SequenceView<float> source, int components, std::uint8_t* destination, std::size_t stride)
+	{
+		auto elementCount = source.Count() / components;
+		Scatter(reinterpret_cast<const std::uint8_t*>(source.begin()), elementCount, components * sizeof(float), destination, stride);
+	}
+}
+
+auto Pargon::GetComponentCount(ShaderElementType type) -> int
+{
+	switch (type)
+	{
+	case ShaderElementType::Float: return 1;
+	case ShaderElementType::Vector2: return 2;
+	case ShaderElementType::Vector3: return 3;
+	case ShaderElementType::Vector4: return 4;
+	case ShaderElementType::Color: return 4;
+	case ShaderElementType::Half2: return 2;
+	case ShaderElementType::Half4: return 4;
+	case ShaderElementType::SignedNormal2x16: return 2;
+	case ShaderElementType::SignedNormal4x16: return 4;
+	case ShaderElementType::UnsignedNormal2x16: return 2;
+	case ShaderElementType::UnsignedNormal4x16: return 4;
+	case ShaderElementType::UnsignedNormal10_10_10_2: return 4;
+	}
+
+	return 0;
+}
+
+void Pargon::PackShaderElements(ShaderElementType type, SequenceView<float> source, BufferReference destination, std::size_t stride)
+{
+	auto components = GetComponentCount(type);
+	auto elementSize = ShaderElement{ type, ShaderElementUsage::Other }.Size();
+
+	assert(components > 0 && source.Count() % components == 0);
+	assert(stride >= elementSize);
+
+	auto elementCount = source.Count() / components;
+
+	if (elementCount == 0)
+		return;
+
+	assert((elementCount - 1) * stride + elementSize <= static_cast<std::size_t>(destination.Size()));
+
+	switch (type)
+	{
+	case ShaderElementType::Float:
+	case ShaderElementType::Vector2:
+	case ShaderElementType::Vector3:
+	case ShaderElementType::Vector4: PackFloats(source, components, destination.begin(), stride); break;
+	case ShaderElementType::Color: Pack32<ColorConversion>(source, destination.begin(), stride); break;
+	case ShaderElementType::Half2:
+	case ShaderElementType::Half4: Pack16<HalfConversion>(source, components, destination.begin(), stride); break;
+	case ShaderElementType::SignedNormal2x16:
+	case ShaderElementType::SignedNormal4x16: Pack16<SignedNormalConversion>(source, components, destination.begin(), stride); break;
+	case ShaderElementType::UnsignedNormal2x16:
+	case ShaderElementType::UnsignedNormal4x16: Pack16<UnsignedNormalConversion>(source, components, destination.begin(), stride); break;
+	case ShaderElementType::UnsignedNormal10_10_10_2: Pack32<PackedConversion>(source, destination.begin(), stride); break;
+	}
+}
+
+void Pargon::PackShaderElements(ShaderElementType type, SequenceView<float> source, const Geometry::Reservation& reservation, std::size_t offset)
+{
+	assert(source.Count() == reservation.ElementCount * GetComponentCount(type));
+	PackShaderElements(type, source, { reservation.Buffer.begin() + offset, static_cast<int>(reservation.Buffer.Size() - offset) }, reservation.ElementSize);
+}
\ No newline at end of file
@@ -22,17 +22,41 @@ namespace
 
 		return 0;
 	}
+
+	void UpdateRange(ID3D11DeviceContext* context, ID3D11Buffer* buffer, UINT capacity, const std::uint8_t* data, std::size_t start, std::size_t size)
+	{
+		D3D11_BOX box;
+		box.left = static_cast<UINT>(start);
+		box.right = std::min(static_cast<UINT>(start + size), capacity);
+		box.top = 0;
+		box.bottom = 1;
+		box.front = 0;
+		box.back = 1;
+
+		if (box.left < box.right)
+			context->UpdateSubresource(buffer, 0, &box, data + start, 0, 0);
+	}
+}
+
+DirectX11GeometryHandle::~DirectX11GeometryHandle()
+{
+	if (MappedVersion >= 0)
+		Renderer->QueueUnmap(Versions.Item(MappedVersion));
 }
 
 auto DirectX11GeometryHandle::Update(Geometry* geometry) -> bool
 {
 	auto renderer = static_cast<DirectX11Renderer*>(geometry->Graphics().Renderer());
 
+	if (geometry->Storage() == GraphicsStorage::MappedToGpu)
+		return UpdateMapped(geometry, renderer);
+
 	auto requiredSize = static_cast<UINT>(geometry->Size());
-	auto dynamic = geometry->Storage() == GraphicsStorage::StreamedToGpu;
 	auto binding = GetBinding(geometry->Topology());
+	auto constant = binding == D3D11_BIND_CONSTANT_BUFFER;
+	auto dynamic = geometry->Storage() == GraphicsStorage::FrameTransient || (geometry->Storage() == GraphicsStorage::StreamedToGpu && constant);
 
-	if (!Buffer || !dynamic || requiredSize > Capacity || binding != Binding)
+	if (!Buffer || requiredSize > Capacity || binding != Binding || (!dynamic && constant && geometry->IsFullyChanged() && requiredSize != Capacity))
 	{
 		Buffer.Reset();
 		Capacity = requiredSize;
@@ -66,6 +90,23 @@ auto DirectX11GeometryHandle::Update(Geometry* geometry) -> bool
 				return false;
 		}
 	}
+	else if (!dynamic)
+	{
+		if (constant)
+		{
+			if (geometry->IsFullyChanged() || !geometry->ChangedRanges().IsEmpty())
+				renderer->Context->UpdateSubresource(Buffer.Get(), 0, nullptr, geometry->Data().begin(), 0, 0);
+		}
+		else if (geometry->IsFullyChanged())
+		{
+			UpdateRange(renderer->Context.Get(), Buffer.Get(), Capacity, geometry->Data().begin(), 0, requiredSize);
+		}
+		else
+		{
+			for (auto& range : geometry->ChangedRanges())
+				UpdateRange(renderer->Context.Get(), Buffer.Get(), Capacity, geometry->Data().begin(), range.Start, range.Size);
+		}
+	}
 	else
 	{
 		if (requiredSize > 0)
@@ -80,4 +121,103 @@ auto DirectX11GeometryHandle::Update(Geometry* geometry) -> bool
 	}
 
 	return true;
+}
+
+auto DirectX11GeometryHandle::Map(Geometry* geometry, std::size_t capacity) -> BufferReference
+{
+	if (capacity > Capacity)
+		return {};
+
+	auto mapped = Mapped.exchange(nullptr, std::memory_order_acquire);
+
+	if (mapped == nullptr)
+		return {};
+
+	return { static_cast<std::uint8_t*>(mapped), static_cast<int>(Capacity) };
+}
+
+auto DirectX11GeometryHandle::UpdateMapped(Geometry* geometry, DirectX11Renderer* renderer) -> bool
+{
+	auto requiredSize = static_cast<UINT>(geometry->Size());
+	auto binding = GetBinding(geometry->Topology());
+	auto written = geometry->IsMapped() ? MappedVersion : -1;
+
+	Renderer = renderer;
+	Unmap();
+
+	if (written >= 0)
+	{
+		Version = written;
+		Buffer = Versions.Item(Version);
+	}
+	else
+	{
+		if (Versions.IsEmpty() || requiredSize > Capacity || binding != Binding)
+		{
+			Buffer.Reset();
+			Versions.Clear();
+			Capacity = requiredSize;
+			Binding = binding;
+			Version = 0;
+
+			if (Capacity == 0)
+				return true;
+
+			D3D11_BUFFER_DESC description;
+			description.ByteWidth = Capacity;
+			description.Usage = D3D11_USAGE_DYNAMIC;
+			description.BindFlags = binding;
+			description.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			description.MiscFlags = 0;
+			description.StructureByteStride = 0;
+
+			auto versions = std::max(geometry->Graphics().FramesInFlight() + 1, 2);
+
+			for (auto i = 0; i < versions; i++)
+			{
+				auto result = renderer->Device->CreateBuffer(&description, nullptr, Versions.Increment().GetAddressOf());
+				if (FAILED(result))
+				{
+					Versions.Clear();
+					return false;
+				}
+			}
+		}
+
+		Version = (Version + 1) % Versions.Count();
+		Buffer = Versions.Item(Version);
+
+		if (requiredSize > 0)
+		{
+			D3D11_MAPPED_SUBRESOURCE resource;
+			ZeroMemory(&resource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+			renderer->Context->Map(Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &resource);
+			std::copy(geometry->Data().begin(), geometry->Data().begin() + requiredSize, reinterpret_cast<char*>(resource.pData));
+			renderer->Context->Unmap(Buffer.Get(), 0);
+		}
+	}
+
+	auto next = (Version + 1) % Versions.Count();
+
+	D3D11_MAPPED_SUBRESOURCE resource;
+	ZeroMemory(&resource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+	if (SUCCEEDED(renderer->Context->Map(Versions.Item(next).Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &resource)))
+	{
+		MappedVersion = next;
+		Mapped.store(resource.pData, std::memory_order_release);
+	}
+
+	return true;
+}
+
+void DirectX11GeometryHandle::Unmap()
+{
+	if (MappedVersion < 0)
+		return;
+
+	Mapped.store(nullptr, std::memory_order_relaxed);
+	Renderer->Context->Unmap(Versions.Item(MappedVersion).Get(), 0);
+	MappedVersion = -1;
 }
\ No newline at end of file
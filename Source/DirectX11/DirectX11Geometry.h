@@ -1,15 +1,19 @@
 #pragma once
 
+#include "Pargon/Containers/List.h"
 #include "Pargon/Graphics/Geometry.h"
 
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 
+#include <atomic>
 #include <d3d11.h>
 #include <wrl.h>
 
 namespace Pargon
 {
+	class DirectX11Renderer;
+
 	class DirectX11GeometryHandle : public GeometryHandle
 	{
 	public:
@@ -17,6 +21,19 @@ namespace Pargon
 		UINT Capacity = 0;
 		UINT Binding;
 
+		DirectX11Renderer* Renderer = nullptr;
+		List<Microsoft::WRL::ComPtr<ID3D11Buffer>> Versions;
+		int Version = 0;
+		int MappedVersion = -1;
+		std::atomic<void*> Mapped{ nullptr };
+
+		~DirectX11GeometryHandle();
+
 		auto Update(Geometry* geometry) -> bool override;
+		auto Map(Geometry* geometry, std::size_t capacity) -> BufferReference override;
+
+	private:
+		auto UpdateMapped(Geometry* geometry, DirectX11Renderer* renderer) -> bool;
+		void Unmap();
 	};
 }
@@ -142,6 +142,13 @@ namespace
 		case ShaderElementType::Point3: return DXGI_FORMAT_R32G32B32_SINT;
 		case ShaderElementType::Point4: return DXGI_FORMAT_R32G32B32A32_SINT;
 		case ShaderElementType::Color: return DXGI_FORMAT_R8G8B8A8_UNORM;
+		case ShaderElementType::Half2: return DXGI_FORMAT_R16G16_FLOAT;
+		case ShaderElementType::Half4: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+		case ShaderElementType::SignedNormal2x16: return DXGI_FORMAT_R16G16_SNORM;
+		case ShaderElementType::SignedNormal4x16: return DXGI_FORMAT_R16G16B16A16_SNORM;
+		case ShaderElementType::UnsignedNormal2x16: return DXGI_FORMAT_R16G16_UNORM;
+		case ShaderElementType::UnsignedNormal4x16: return DXGI_FORMAT_R16G16B16A16_UNORM;
+		case ShaderElementType::UnsignedNormal10_10_10_2: return DXGI_FORMAT_R10G10B10A2_UNORM;
 		}
 
 		return DXGI_FORMAT_UNKNOWN;
@@ -155,11 +162,13 @@ namespace
 
 		for (auto& element : vertexElements)
 		{
+			assert(element.Stream >= 0 && element.Stream < MaximumVertexStreams);
+
 			auto& item = layout.Increment();
 			item.SemanticName = GetUsage(element.Usage);
 			item.SemanticIndex = usageIndex.Item(static_cast<int>(element.Usage))++;
 			item.Format = GetType(element.Type);
-			item.InputSlot = 0;
+			item.InputSlot = element.Stream;
 			item.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 			item.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
 			item.InstanceDataStepRate = 0;
@@ -171,7 +180,7 @@ namespace
 			item.SemanticName = GetUsage(element.Usage);
 			item.SemanticIndex = usageIndex.Item(static_cast<int>(element.Usage))++;
 			item.Format = GetType(element.Type);
-			item.InputSlot = 1;
+			item.InputSlot = MaximumVertexStreams;
 			item.AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
 			item.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
 			item.InstanceDataStepRate = 1;
@@ -282,7 +291,7 @@ auto DirectX11MaterialHandle::Update(Material* material) -> bool
 		auto result = renderer->Device->CreateSamplerState(&description, state.GetAddressOf());
 	}
 
-	auto layout = GetLayoutDescription(material->VertexLayout, material->InstanceLayout);
+	auto layout = GetLayoutDescription(material->VertexLayout(), material->InstanceLayout());
 	result = renderer->Device->CreateInputLayout(layout.begin(), layout.Count(), material->VertexShader.begin(), material->VertexShader.Size(), Layout.GetAddressOf());
 
 	return true;
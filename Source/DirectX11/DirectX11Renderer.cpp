@@ -6,7 +6,6 @@
 #include "Pargon/Application.Win32.h"
 #include "Pargon/Graphics.DirectX11.h"
 
-#include <D3D11_1.h>
 #include <D3Dcompiler.h>
 
 using namespace Pargon;
@@ -18,6 +17,7 @@ auto Pargon::CreateDirectX11Renderer() -> std::unique_ptr<Renderer>
 
 DirectX11Renderer::~DirectX11Renderer()
 {
+	ProcessUnmaps();
 	CoUninitialize();
 }
 
@@ -84,11 +84,62 @@ auto DirectX11Renderer::CreateTextureHandle() -> std::unique_ptr<TextureHandle>
 	return std::make_unique<DirectX11TextureHandle>();
 }
 
+void DirectX11Renderer::QueueUnmap(Microsoft::WRL::ComPtr<ID3D11Buffer> buffer)
+{
+	std::lock_guard<std::mutex> lock(_unmapGuard);
+	_pendingUnmaps.Add(std::move(buffer));
+}
+
+void DirectX11Renderer::ProcessUnmaps()
+{
+	std::lock_guard<std::mutex> lock(_unmapGuard);
+
+	for (auto& buffer : _pendingUnmaps)
+		Context->Unmap(buffer.Get(), 0);
+
+	_pendingUnmaps.Clear();
+}
+
 void DirectX11Renderer::BeginFrame()
 {
+	ProcessUnmaps();
+}
+
+void DirectX11Renderer::Execute(SequenceView<RenderPacket> packets)
+{
+	for (auto& packet : packets)
+	{
+		auto& data = packet.Data;
+
+		switch (packet.Type)
+		{
+		case RenderPacketType::SetRenderTarget: BindRenderTarget(data.SetTarget.Texture, static_cast<DirectX11TextureHandle*>(data.SetTarget.Handle), data.SetTarget.Slot); break;
+		case RenderPacketType::ClearColorTarget: DirectX11Renderer::ClearColorTarget(data.ClearColorTarget.R, data.ClearColorTarget.G, data.ClearColorTarget.B, data.ClearColorTarget.A); break;
+		case RenderPacketType::SetDepthStencilTarget: BindDepthStencilTarget(static_cast<DirectX11TextureHandle*>(data.SetTarget.Handle)); break;
+		case RenderPacketType::ClearDepthAndStencilTarget: DirectX11Renderer::ClearDepthAndStencilTarget(data.ClearDepthAndStencilTarget.Depth, data.ClearDepthAndStencilTarget.Stencil); break;
+		case RenderPacketType::SetClippingRectangle: DirectX11Renderer::SetClippingRectangle(data.SetClippingRectangle.X, data.SetClippingRectangle.Y, data.SetClippingRectangle.Width, data.SetClippingRectangle.Height); break;
+		case RenderPacketType::SetMaterial: BindMaterial(data.SetMaterial.Material, static_cast<DirectX11MaterialHandle*>(data.SetMaterial.Handle)); break;
+		case RenderPacketType::SetTexture: BindTexture(static_cast<DirectX11TextureHandle*>(data.SetTarget.Handle), data.SetTarget.Slot); break;
+		case RenderPacketType::SetVertexBuffer: BindVertexBuffer(data.SetBuffer.Geometry, static_cast<DirectX11GeometryHandle*>(data.SetBuffer.Handle), data.SetBuffer.ElementSize); break;
+		case RenderPacketType::SetVertexStream: BindVertexStream(static_cast<DirectX11GeometryHandle*>(data.SetStream.Handle), data.SetStream.ElementSize, data.SetStream.Stream); break;
+		case RenderPacketType::SetInstanceBuffer: BindInstanceBuffer(static_cast<DirectX11GeometryHandle*>(data.SetBuffer.Handle), data.SetBuffer.ElementSize); break;
+		case RenderPacketType::SetIndexBuffer: BindIndexBuffer(static_cast<DirectX11GeometryHandle*>(data.SetBuffer.Handle), data.SetBuffer.ElementSize); break;
+		case RenderPacketType::SetConstantBuffer: BindConstantBuffer(static_cast<DirectX11GeometryHandle*>(data.SetConstantBuffer.Handle), data.SetConstantBuffer.VertexAccess, data.SetConstantBuffer.FragmentAccess, data.SetConstantBuffer.Offset, data.SetConstantBuffer.Size, data.SetConstantBuffer.Slot); break;
+		case RenderPacketType::DrawVertices: DirectX11Renderer::DrawVertices(data.Draw.First, data.Draw.Count); break;
+		case RenderPacketType::DrawIndices: DirectX11Renderer::DrawIndices(data.Draw.First, data.Draw.Count); break;
+		case RenderPacketType::DrawInstances: DirectX11Renderer::DrawInstances(data.Draw.First, data.Draw.Count, data.Draw.FirstInstance, data.Draw.InstanceCount); break;
+		case RenderPacketType::DrawIndexedInstances: DirectX11Renderer::DrawIndexedInstances(data.Draw.First, data.Draw.Count, data.Draw.FirstInstance, data.Draw.InstanceCount); break;
+		case RenderPacketType::MultiDraw: DirectX11Renderer::MultiDraw({ data.MultiDraw.Ranges, data.MultiDraw.Count }, data.MultiDraw.Indexed); break;
+		}
+	}
 }
 
 void DirectX11Renderer::SetRenderTarget(Texture* texture, int slot)
+{
+	BindRenderTarget(texture, texture == nullptr ? nullptr : texture->Handle<DirectX11TextureHandle>(), slot);
+}
+
+void DirectX11Renderer::BindRenderTarget(Texture* texture, DirectX11TextureHandle* textureHandle, int slot)
 {
 	if (slot > _currentRenderTargets.Count())
 		return;
@@ -102,7 +153,6 @@ void DirectX11Renderer::SetRenderTarget(Texture* texture, int slot)
 	}
 	else
 	{
-		auto textureHandle = texture->Handle<DirectX11TextureHandle>();
 		Microsoft::WRL::ComPtr<ID3D11RenderTargetView> view;
 
 		textureHandle->View.As(std::addressof(view));
@@ -135,13 +185,17 @@ void DirectX11Renderer::ClearColorTarget(float r, float g, float b, float a)
 
 void DirectX11Renderer::SetDepthStencilTarget(Texture* texture)
 {
-	if (texture == nullptr)
+	BindDepthStencilTarget(texture == nullptr ? nullptr : texture->Handle<DirectX11TextureHandle>());
+}
+
+void DirectX11Renderer::BindDepthStencilTarget(DirectX11TextureHandle* textureHandle)
+{
+	if (textureHandle == nullptr)
 	{
 		_currentDepthStencilTarget = nullptr;
 	}
 	else
 	{
-		auto textureHandle = texture->Handle<DirectX11TextureHandle>();
 		Microsoft::WRL::ComPtr<ID3D11DepthStencilView> view;
 
 		textureHandle->View.As(std::addressof(view));
@@ -171,11 +225,14 @@ void DirectX11Renderer::SetClippingRectangle(float x, float y, float width, floa
 }
 
 void DirectX11Renderer::SetMaterial(Material* material)
+{
+	BindMaterial(material, material == nullptr ? nullptr : material->Handle<DirectX11MaterialHandle>());
+}
+
+void DirectX11Renderer::BindMaterial(Material* material, DirectX11MaterialHandle* materialHandle)
 {
 	if (material != nullptr)
 	{
-		auto materialHandle = material->Handle<DirectX11MaterialHandle>();
-
 		if (materialHandle->VertexShader && materialHandle->PixelShader && materialHandle->Layout)
 		{
 			Context->VSSetShader(materialHandle->VertexShader.Get(), nullptr, 0);
@@ -198,17 +255,20 @@ void DirectX11Renderer::SetMaterial(Material* material)
 }
 
 void DirectX11Renderer::SetTexture(Texture* texture, int slot)
+{
+	BindTexture(texture == nullptr ? nullptr : texture->Handle<DirectX11TextureHandle>(), slot);
+}
+
+void DirectX11Renderer::BindTexture(DirectX11TextureHandle* textureHandle, int slot)
 {
 	ID3D11ShaderResourceView* clear[1] = { nullptr };
 
-	if (texture == nullptr)
+	if (textureHandle == nullptr)
 	{
 		Context->PSSetShaderResources(slot, 1, clear);
 	}
 	else
 	{
-		auto textureHandle = texture->Handle<DirectX11TextureHandle>();
-
 		if (textureHandle->SampleCount > 1)
 			Context->ResolveSubresource(textureHandle->Texture2d.Get(), 0, textureHandle->Texture2dMs.Get(), 0, DXGI_FORMAT_R8G8B8A8_UNORM);
 
@@ -233,19 +293,22 @@ namespace
 }
 
 void DirectX11Renderer::SetVertexBuffer(Geometry* geometry, std::size_t vertexSize)
+{
+	BindVertexBuffer(geometry, geometry == nullptr ? nullptr : geometry->Handle<DirectX11GeometryHandle>(), vertexSize);
+}
+
+void DirectX11Renderer::BindVertexBuffer(Geometry* geometry, DirectX11GeometryHandle* geometryHandle, std::size_t vertexSize)
 {
 	auto offset = 0u;
 	auto size = static_cast<UINT>(vertexSize);
 
-	if (geometry == nullptr)
+	if (geometryHandle == nullptr)
 	{
 		ID3D11Buffer* vertexBuffers[1] = { nullptr };
 		Context->IASetVertexBuffers(0, 1, vertexBuffers, &size, &offset);
 	}
 	else
 	{
-		auto geometryHandle = geometry->Handle<DirectX11GeometryHandle>();
-
 		if (geometryHandle->Buffer)
 		{
 			ID3D11Buffer* vertexBuffers[1] = { geometryHandle->Buffer.Get() };
@@ -257,67 +320,83 @@ void DirectX11Renderer::SetVertexBuffer(Geometry* geometry, std::size_t vertexSi
 	}
 }
 
-void DirectX11Renderer::SetInstanceBuffer(Geometry* geometry, std::size_t vertexSize)
+void DirectX11Renderer::SetVertexStream(Geometry* geometry, std::size_t vertexSize, int stream)
+{
+	BindVertexStream(geometry == nullptr ? nullptr : geometry->Handle<DirectX11GeometryHandle>(), vertexSize, stream);
+}
+
+void DirectX11Renderer::BindVertexStream(DirectX11GeometryHandle* geometryHandle, std::size_t vertexSize, int stream)
 {
 	auto offset = 0u;
 	auto size = static_cast<UINT>(vertexSize);
+	auto slot = static_cast<UINT>(stream);
 
-	if (geometry == nullptr)
+	if (geometryHandle == nullptr)
 	{
 		ID3D11Buffer* vertexBuffers[1] = { nullptr };
-		Context->IASetVertexBuffers(1, 1, vertexBuffers, &size, &offset);
+		Context->IASetVertexBuffers(slot, 1, vertexBuffers, &size, &offset);
 	}
 	else
 	{
-		auto geometryHandle = geometry->Handle<DirectX11GeometryHandle>();
-
 		if (geometryHandle->Buffer)
 		{
 			ID3D11Buffer* vertexBuffers[1] = { geometryHandle->Buffer.Get() };
-			Context->IASetVertexBuffers(1, 1, vertexBuffers, &size, &offset);
+			Context->IASetVertexBuffers(slot, 1, vertexBuffers, &size, &offset);
 		}
 	}
 }
 
+void DirectX11Renderer::SetInstanceBuffer(Geometry* geometry, std::size_t vertexSize)
+{
+	BindInstanceBuffer(geometry == nullptr ? nullptr : geometry->Handle<DirectX11GeometryHandle>(), vertexSize);
+}
+
+void DirectX11Renderer::BindInstanceBuffer(DirectX11GeometryHandle* geometryHandle, std::size_t vertexSize)
+{
+	BindVertexStream(geometryHandle, vertexSize, MaximumVertexStreams);
+}
+
 void DirectX11Renderer::SetIndexBuffer(Geometry* geometry, std::size_t indexSize)
 {
-	if (geometry == nullptr)
+	BindIndexBuffer(geometry == nullptr ? nullptr : geometry->Handle<DirectX11GeometryHandle>(), indexSize);
+}
+
+void DirectX11Renderer::BindIndexBuffer(DirectX11GeometryHandle* geometryHandle, std::size_t indexSize)
+{
+	if (geometryHandle == nullptr)
 	{
 		Context->IASetIndexBuffer(nullptr, indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
 	}
 	else
 	{
-		auto geometryHandle = geometry->Handle<DirectX11GeometryHandle>();
-
 		if (geometryHandle->Buffer)
 			Context->IASetIndexBuffer(geometryHandle->Buffer.Get(), indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
 	}
 }
 
 void DirectX11Renderer::SetConstantBuffer(Geometry* geometry, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot)
+{
+	BindConstantBuffer(geometry == nullptr ? nullptr : geometry->Handle<DirectX11GeometryHandle>(), vertexAccess, fragmentAccess, offset, size, slot);
+}
+
+void DirectX11Renderer::BindConstantBuffer(DirectX11GeometryHandle* geometryHandle, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot)
 {
 	ID3D11Buffer* clear[1] = { nullptr };
 
-	if (geometry == nullptr)
+	if (geometryHandle == nullptr)
 	{
 		Context->VSSetConstantBuffers(slot, 1, clear);
 		Context->PSSetConstantBuffers(slot, 1, clear);
 	}
 	else
 	{
-		auto geometryHandle = geometry->Handle<DirectX11GeometryHandle>();
-
 		ID3D11Buffer* constantBuffers[1] = { geometryHandle->Buffer.Get() };
 
-		ID3D11DeviceContext1* context;
-		Context->QueryInterface<ID3D11DeviceContext1>(std::addressof(context));
-
 		auto first = static_cast<UINT>(offset);
 		auto count = static_cast<UINT>(((size + 255) >> 8) << 4);
 
-		context->VSSetConstantBuffers1(slot, 1, vertexAccess ? constantBuffers : clear, &first, &count);
-		context->PSSetConstantBuffers1(slot, 1, fragmentAccess ? constantBuffers : clear, &first, &count);
-		context->Release();
+		Context1->VSSetConstantBuffers1(slot, 1, vertexAccess ? constantBuffers : clear, &first, &count);
+		Context1->PSSetConstantBuffers1(slot, 1, fragmentAccess ? constantBuffers : clear, &first, &count);
 	}
 }
 
@@ -345,6 +424,20 @@ void DirectX11Renderer::DrawIndexedInstances(int firstIndex, int indexCount, int
 		Context->DrawIndexedInstanced(indexCount, instanceCount, firstIndex, 0, firstInstance);
 }
 
+void DirectX11Renderer::MultiDraw(SequenceView<DrawRange> ranges, bool indexed)
+{
+	for (auto& range : ranges)
+	{
+		if (range.IndexCount <= 0 || range.InstanceCount <= 0)
+			continue;
+
+		if (indexed)
+			Context->DrawIndexedInstanced(range.IndexCount, range.InstanceCount, range.FirstIndex, range.BaseVertex, range.FirstInstance);
+		else
+			Context->DrawInstanced(range.IndexCount, range.InstanceCount, range.FirstIndex, range.FirstInstance);
+	}
+}
+
 void DirectX11Renderer::EndFrame(int synchronization)
 {
 	SwapChain->Present(synchronization, 0);
@@ -387,6 +480,7 @@ void DirectX11Renderer::CreateDevice(bool debug)
 
 	device.As(&Device);
 	context.As(&Context);
+	context.As(&Context1);
 }
 
 void DirectX11Renderer::CreateSwapChain(IUnknown* window, HWND handle, int width, int height)
@@ -6,13 +6,20 @@
 #define WIN32_LEAN_AND_MEAN
 
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <wrl.h>
 
+#include <mutex>
+
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
 namespace Pargon
 {
+	class DirectX11GeometryHandle;
+	class DirectX11MaterialHandle;
+	class DirectX11TextureHandle;
+
 	class DirectX11Renderer : public Renderer
 	{
 	public:
@@ -20,6 +27,7 @@ namespace Pargon
 
 		Microsoft::WRL::ComPtr<ID3D11Device> Device;
 		Microsoft::WRL::ComPtr<ID3D11DeviceContext> Context;
+		Microsoft::WRL::ComPtr<ID3D11DeviceContext1> Context1;
 		Microsoft::WRL::ComPtr<IDXGISwapChain> SwapChain;
 		Microsoft::WRL::ComPtr<ID3D11RenderTargetView> RenderTarget;
 
@@ -30,6 +38,8 @@ namespace Pargon
 
 		auto CompileShader(StringView content, Material& material) -> ShaderCompilationResult override;
 
+		void QueueUnmap(Microsoft::WRL::ComPtr<ID3D11Buffer> buffer);
+
 	protected:
 		void Setup(Application& application, RendererInformation& information) override;
 
@@ -38,6 +48,7 @@ namespace Pargon
 		auto CreateTextureHandle() -> std::unique_ptr<TextureHandle> override;
 
 		void BeginFrame() override;
+		void Execute(SequenceView<RenderPacket> packets) override;
 		void SetRenderTarget(Texture* texture, int slot) override;
 		void ClearColorTarget(float r, float g, float b, float a) override;
 		void SetDepthStencilTarget(Texture* texture) override;
@@ -46,6 +57,7 @@ namespace Pargon
 		void SetMaterial(Material* material) override;
 		void SetTexture(Texture* texture, int slot) override;
 		void SetVertexBuffer(Geometry* geometry, std::size_t vertexSize) override;
+		void SetVertexStream(Geometry* geometry, std::size_t vertexSize, int stream) override;
 		void SetInstanceBuffer(Geometry* geometry, std::size_t vertexSize) override;
 		void SetIndexBuffer(Geometry* geometry, std::size_t indexSize) override;
 		void SetConstantBuffer(Geometry* geometry, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot) override;
@@ -53,6 +65,7 @@ namespace Pargon
 		void DrawIndices(int firstIndex, int indexCount) override;
 		void DrawInstances(int firstVertex, int vertexCount, int firstInstance, int instanceCount) override;
 		void DrawIndexedInstances(int firstIndex, int indexCount, int firstInstance, int instanceCount) override;
+		void MultiDraw(SequenceView<DrawRange> ranges, bool indexed) override;
 		void EndFrame(int synchronization) override;
 
 	private:
@@ -61,6 +74,20 @@ namespace Pargon
 		D3D11_VIEWPORT _currentViewport;
 		int _frameSynchronization;
 
+		std::mutex _unmapGuard;
+		List<Microsoft::WRL::ComPtr<ID3D11Buffer>> _pendingUnmaps;
+
+		void BindRenderTarget(Texture* texture, DirectX11TextureHandle* textureHandle, int slot);
+		void BindDepthStencilTarget(DirectX11TextureHandle* textureHandle);
+		void BindMaterial(Material* material, DirectX11MaterialHandle* materialHandle);
+		void BindTexture(DirectX11TextureHandle* textureHandle, int slot);
+		void BindVertexBuffer(Geometry* geometry, DirectX11GeometryHandle* geometryHandle, std::size_t vertexSize);
+		void BindVertexStream(DirectX11GeometryHandle* geometryHandle, std::size_t vertexSize, int stream);
+		void BindInstanceBuffer(DirectX11GeometryHandle* geometryHandle, std::size_t vertexSize);
+		void BindIndexBuffer(DirectX11GeometryHandle* geometryHandle, std::size_t indexSize);
+		void BindConstantBuffer(DirectX11GeometryHandle* geometryHandle, bool vertexAccess, bool fragmentAccess, int offset, std::size_t size, int slot);
+
+		void ProcessUnmaps();
 		auto GetAvailableSampleCounts() const -> List<int>;
 
 		void CreateDevice(bool debug);